@@ -325,6 +325,55 @@ void CardboardHeadTracker_addSixDoFData(CardboardHeadTracker* head_tracker,
   static_cast<cardboard::HeadTracker*>(head_tracker)->AddSixDoFData(timestamp_ns, position, orientation);
 }
 
+void CardboardHeadTracker_setRotationPredictionModel(
+    CardboardHeadTracker* head_tracker,
+    CardboardRotationPredictionModel model) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->SetRotationPredictionModel(model);
+}
+
+void CardboardHeadTracker_setGyroscopeBiasEstimation(
+    CardboardHeadTracker* head_tracker,
+    CardboardGyroscopeBiasEstimation estimation) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->SetGyroscopeBiasEstimation(estimation);
+}
+
+void CardboardHeadTracker_setPositionPredictionModel(
+    CardboardHeadTracker* head_tracker,
+    CardboardPositionPredictionModel model) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker)) {
+    return;
+  }
+  static_cast<cardboard::HeadTracker*>(head_tracker)
+      ->SetPositionPredictionModel(model);
+}
+
+int CardboardHeadTracker_getSixDoFTimeOffset(CardboardHeadTracker* head_tracker,
+                                             int64_t* offset_ns,
+                                             int64_t* offset_stddev_ns,
+                                             float* drift_ppm) {
+  if (CARDBOARD_IS_NOT_INITIALIZED() || CARDBOARD_IS_ARG_NULL(head_tracker) ||
+      CARDBOARD_IS_ARG_NULL(offset_ns) ||
+      CARDBOARD_IS_ARG_NULL(offset_stddev_ns) ||
+      CARDBOARD_IS_ARG_NULL(drift_ppm)) {
+    return 0;
+  }
+  const cardboard::SixDoFTimeOffsetEstimator::Estimate estimate =
+      static_cast<cardboard::HeadTracker*>(head_tracker)
+          ->GetSixDoFTimeOffset();
+  *offset_ns = std::llround(estimate.offset_ns);
+  *offset_stddev_ns = std::llround(estimate.offset_stddev_ns);
+  *drift_ppm = static_cast<float>(estimate.drift * 1e6);
+  return estimate.is_valid ? 1 : 0;
+}
+
 //void CardboardQrCode_getSavedDeviceParams(uint8_t** encoded_device_params,
 //                                          int* size) {
 //  if (CARDBOARD_IS_NOT_INITIALIZED() ||
@@ -53,6 +53,63 @@ class CardboardInputApi {
   // TODO(b/154305848): Move argument types to std::array*.
   void GetHeadTrackerPose(float* position, float* orientation);
 
+  /// @brief Gets the pose of the HeadTracker module predicted for the moment
+  ///        the frame being rendered is displayed.
+  /// @details Behaves like GetHeadTrackerPose(), but predicts to
+  ///          @p target_display_time_nano instead of the current time plus
+  ///          the default prediction time. The target is clamped to
+  ///          [now, now + kMaximumPredictionTimeNanos], so that a stale or
+  ///          mistaken timestamp cannot make the prediction diverge.
+  /// @param[in] target_display_time_nano The time at which the frame reaches
+  ///            the display, in nanoseconds of the clock returned by
+  ///            GetBootTimeNano() (CLOCK_UPTIME_RAW on iOS, the clock of
+  ///            CACurrentMediaTime() and CADisplayLink timestamps).
+  /// @param[out] position A pointer to an array with three floats to fill in
+  ///             the position of the head.
+  /// @param[out] orientation A pointer to an array with four floats to fill in
+  ///             the quaternion that denotes the orientation of the head.
+  void GetHeadTrackerPoseAtTime(int64_t target_display_time_nano,
+                                float* position, float* orientation);
+
+  /// @brief Gets the pose of the HeadTracker module predicted for the vsync
+  ///        at which the frame being rendered is displayed.
+  /// @details The frame is displayed @p pipeline_depth refresh periods after
+  ///          @p vsync_time_nano. See GetHeadTrackerPoseAtTime().
+  /// @param[in] vsync_time_nano The timestamp of the last vsync, in the clock
+  ///            of GetHeadTrackerPoseAtTime().
+  /// @param[in] refresh_period_nano The display refresh period in nanoseconds,
+  ///            8333333 on a 120 Hz display.
+  /// @param[in] pipeline_depth The number of refresh periods between
+  ///            @p vsync_time_nano and the display of the frame.
+  /// @param[out] position A pointer to an array with three floats to fill in
+  ///             the position of the head.
+  /// @param[out] orientation A pointer to an array with four floats to fill in
+  ///             the quaternion that denotes the orientation of the head.
+  void GetHeadTrackerPoseForVsync(int64_t vsync_time_nano,
+                                  int64_t refresh_period_nano,
+                                  int pipeline_depth, float* position,
+                                  float* orientation);
+
+  /// @brief Sets how far ahead of the current time GetHeadTrackerPose()
+  ///        predicts the pose. Defaults to kDefaultPredictionTimeNanos.
+  /// @param prediction_time_nano The prediction time in nanoseconds, clamped
+  ///        to [0, kMaximumPredictionTimeNanos].
+  void SetPredictionTime(int64_t prediction_time_nano);
+
+  /// @brief Gets the prediction time used by GetHeadTrackerPose().
+  /// @return The prediction time in nanoseconds.
+  int64_t GetPredictionTime() const;
+
+  /// @brief Gets the estimated offset between the 6DoF timestamps and the IMU
+  ///        clock, for telemetry.
+  /// @param[out] offset_ns The offset in nanoseconds.
+  /// @param[out] offset_stddev_ns The standard deviation of the offset in
+  ///             nanoseconds.
+  /// @param[out] drift_ppm The drift of the offset in parts per million.
+  /// @return True once the offset has been estimated.
+  bool GetSixDoFTimeOffset(int64_t* offset_ns, int64_t* offset_stddev_ns,
+                           float* drift_ppm);
+
   /// Aryzon 6DoF
   /// @brief Add a 6DoF pose sample to the HeadTracker module.
   /// @param[in] timestamp_nano A timestamp of the moment the 6DoF data was captured in nanoseconds
@@ -68,6 +125,18 @@ class CardboardInputApi {
 
   /// @brief Flags a head tracker recentering request.
   static void SetHeadTrackerRecenterRequested();
+
+  /// @brief Selects the motion model used to predict the head orientation.
+  /// @param model The prediction model.
+  void SetRotationPredictionModel(CardboardRotationPredictionModel model);
+
+  /// @brief Selects how the gyroscope bias is estimated.
+  /// @param estimation The gyroscope bias estimation.
+  void SetGyroscopeBiasEstimation(CardboardGyroscopeBiasEstimation estimation);
+
+  /// @brief Selects the motion model used to extrapolate the head position.
+  /// @param model The prediction model.
+  void SetPositionPredictionModel(CardboardPositionPredictionModel model);
     
  private:
   // @brief Custom deleter for HeadTracker.
@@ -81,8 +150,17 @@ class CardboardInputApi {
   // @return The system boot time count in nanoseconds.
   static int64_t GetBootTimeNano();
 
-  // @brief Default prediction excess time in nano seconds.
-  static constexpr int64_t kPredictionTimeWithoutVsyncNanos = 50000000;
+  // @brief Gets the pose predicted to @p timestamp_nano, once @p
+  //        timestamp_nano has been clamped to the supported horizon.
+  void GetHeadTrackerPoseAtClampedTime(int64_t timestamp_nano, float* position,
+                                       float* orientation);
+
+  // @brief Default prediction excess time in nano seconds, used when the
+  //        caller does not provide the display time.
+  static constexpr int64_t kDefaultPredictionTimeNanos = 50000000;
+
+  // @brief Maximum prediction excess time in nano seconds.
+  static constexpr int64_t kMaximumPredictionTimeNanos = 200000000;
 
   // @brief Constant to convert seconds into nano seconds.
   static constexpr int64_t kNanosInSeconds = 1000000000;
@@ -91,6 +169,9 @@ class CardboardInputApi {
   std::unique_ptr<CardboardHeadTracker, CardboardHeadTrackerDeleter>
       head_tracker_;
 
+  // @brief Prediction excess time of GetHeadTrackerPose() in nano seconds.
+  std::atomic<int64_t> prediction_time_nanos_{kDefaultPredictionTimeNanos};
+
   // @brief Holds the selected viewport orientation.
   static std::atomic<CardboardViewportOrientation>
       selected_viewport_orientation_;
@@ -15,6 +15,7 @@
  */
 #include "cardboard_input_api.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 
@@ -89,6 +90,55 @@ void CardboardInputApi::ResumeHeadTracker() {
 
 void CardboardInputApi::GetHeadTrackerPose(float* position,
                                            float* orientation) {
+  GetHeadTrackerPoseAtClampedTime(GetBootTimeNano() + prediction_time_nanos_,
+                                  position, orientation);
+}
+
+void CardboardInputApi::GetHeadTrackerPoseAtTime(
+    int64_t target_display_time_nano, float* position, float* orientation) {
+  const int64_t now = GetBootTimeNano();
+  GetHeadTrackerPoseAtClampedTime(
+      std::clamp(target_display_time_nano, now,
+                 now + kMaximumPredictionTimeNanos),
+      position, orientation);
+}
+
+void CardboardInputApi::GetHeadTrackerPoseForVsync(int64_t vsync_time_nano,
+                                                   int64_t refresh_period_nano,
+                                                   int pipeline_depth,
+                                                   float* position,
+                                                   float* orientation) {
+  GetHeadTrackerPoseAtTime(
+      vsync_time_nano + pipeline_depth * refresh_period_nano, position,
+      orientation);
+}
+
+void CardboardInputApi::SetPredictionTime(int64_t prediction_time_nano) {
+  prediction_time_nanos_ =
+      std::clamp<int64_t>(prediction_time_nano, 0, kMaximumPredictionTimeNanos);
+}
+
+int64_t CardboardInputApi::GetPredictionTime() const {
+  return prediction_time_nanos_;
+}
+
+bool CardboardInputApi::GetSixDoFTimeOffset(int64_t* offset_ns,
+                                            int64_t* offset_stddev_ns,
+                                            float* drift_ppm) {
+  if (head_tracker_ == nullptr) {
+    LOGW("Uninitialized head tracker was queried for the 6DoF time offset.");
+    *offset_ns = 0;
+    *offset_stddev_ns = 0;
+    *drift_ppm = 0.0f;
+    return false;
+  }
+  return CardboardHeadTracker_getSixDoFTimeOffset(
+             head_tracker_.get(), offset_ns, offset_stddev_ns, drift_ppm) != 0;
+}
+
+void CardboardInputApi::GetHeadTrackerPoseAtClampedTime(int64_t timestamp_nano,
+                                                        float* position,
+                                                        float* orientation) {
   if (head_tracker_ == nullptr) {
     LOGW("Uninitialized head tracker was queried for the pose.");
     position[0] = 0.0f;
@@ -107,9 +157,9 @@ void CardboardInputApi::GetHeadTrackerPose(float* position,
     head_tracker_recenter_requested_ = false;
   }
 
-  CardboardHeadTracker_getPose(
-      head_tracker_.get(), GetBootTimeNano() + kPredictionTimeWithoutVsyncNanos,
-      selected_viewport_orientation_, position, orientation);
+  CardboardHeadTracker_getPose(head_tracker_.get(), timestamp_nano,
+                               selected_viewport_orientation_, position,
+                               orientation);
 }
 
 void CardboardInputApi::SetViewportOrientation(
@@ -121,6 +171,34 @@ void CardboardInputApi::SetHeadTrackerRecenterRequested() {
   head_tracker_recenter_requested_ = true;
 }
 
+void CardboardInputApi::SetRotationPredictionModel(
+    CardboardRotationPredictionModel model) {
+  if (head_tracker_ == nullptr) {
+    LOGW("Uninitialized head tracker was given a prediction model.");
+    return;
+  }
+  CardboardHeadTracker_setRotationPredictionModel(head_tracker_.get(), model);
+}
+
+void CardboardInputApi::SetGyroscopeBiasEstimation(
+    CardboardGyroscopeBiasEstimation estimation) {
+  if (head_tracker_ == nullptr) {
+    LOGW("Uninitialized head tracker was given a gyroscope bias estimation.");
+    return;
+  }
+  CardboardHeadTracker_setGyroscopeBiasEstimation(head_tracker_.get(),
+                                                  estimation);
+}
+
+void CardboardInputApi::SetPositionPredictionModel(
+    CardboardPositionPredictionModel model) {
+  if (head_tracker_ == nullptr) {
+    LOGW("Uninitialized head tracker was given a position prediction model.");
+    return;
+  }
+  CardboardHeadTracker_setPositionPredictionModel(head_tracker_.get(), model);
+}
+
 // Aryzon 6DoF
 void CardboardInputApi::AddSixDoFData(int64_t timestamp_nano, float* position, float* orientation) {
     //LOGW("Head tracker was queried when setting 6DoF data.");
@@ -25,83 +25,133 @@
 namespace cardboard {
 
 // Aryzon 6DoF
-constexpr int kRotationSamples = 10;
+// The IMU samples kept to apply the 6DoF orientations at their capture time.
+// 128 samples are 640 ms of accelerometer and gyroscope samples at 100 Hz,
+// several times the ARKit latency, and bound a replay to about 40 us.
+constexpr size_t kReplaySamples = 128;
+constexpr size_t kReplayCheckpointInterval = 8;
 constexpr int kPositionSamples = 6;
+// Gravity in the 6DoF world space, which is y up, as measured by the
+// accelerometer at rest.
+constexpr Vector3 kSixDoFWorldGravity(0.0, 9.8, 0.0);
 constexpr int64_t kMaxSixDoFTimeDifference = 200000000; // Maximum time difference between last pose state timestamp and last 6DoF timestamp, if it takes longer than this the last known location of sixdof will be used
-constexpr float kReduceBiasRate = 0.05;
 
-const std::array<Rotation, 4> HeadTracker::kEkfToHeadTrackerRotations{
+namespace {
+
+// sqrt(2) / 2, the components of the quarter turn quaternions below.
+constexpr double kHalfSqrt2 = 0.7071067811865476;
+
+// @{ Hold rotations to adapt the pose estimation to the viewport and head
+// poses. Use the following indexing for each viewport orientation:
+// [0]: Landscape left.
+// [1]: Landscape right.
+// [2]: Portrait.
+// [3]: Portrait upside down.
+//
+// The quaternions are written out so that the tables are compile-time
+// constants rather than being built with sin() and cos() at load time.
+constexpr std::array<Rotation, 4> kEkfToHeadTrackerRotations{
     // LandscapeLeft: This is the same than initializing the rotation from
     // Rotation::FromYawPitchRoll(-M_PI / 2., 0, -M_PI / 2.).
-    Rotation::FromQuaternion(Rotation::QuaternionType(0.5, -0.5, -0.5, 0.5)),
+    Rotation::FromNormalizedQuaternion(Vector4(0.5, -0.5, -0.5, 0.5)),
     // LandscapeRight: This is the same than initializing the rotation from
     // Rotation::FromYawPitchRoll(M_PI / 2., 0, M_PI / 2.).
-    Rotation::FromQuaternion(Rotation::QuaternionType(0.5, 0.5, 0.5, 0.5)),
+    Rotation::FromNormalizedQuaternion(Vector4(0.5, 0.5, 0.5, 0.5)),
     // Portrait: This is the same than initializing the rotation from
     // Rotation::FromYawPitchRoll(M_PI / 2., M_PI / 2., M_PI / 2.).
-    Rotation::FromQuaternion(Rotation::QuaternionType(0.7071067811865476, 0.,
-                                                      0., 0.7071067811865476)),
+    Rotation::FromNormalizedQuaternion(
+        Vector4(kHalfSqrt2, 0., 0., kHalfSqrt2)),
     // Portrait upside down: This is the same than initializing the rotation
     // from Rotation::FromYawPitchRoll(-M_PI / 2., -M_PI / 2., -M_PI / 2.).
-    Rotation::FromQuaternion(Rotation::QuaternionType(
-        0., -0.7071067811865476, -0.7071067811865476, 0.))};
+    Rotation::FromNormalizedQuaternion(
+        Vector4(0., -kHalfSqrt2, -kHalfSqrt2, 0.))};
 
-const std::array<Rotation, 4> HeadTracker::kSensorToDisplayRotations{
+constexpr std::array<Rotation, 4> kSensorToDisplayRotations{
     // LandscapeLeft: This is the same than initializing the rotation from
     // Rotation::FromAxisAndAngle(Vector3(0., 0., 1.), M_PI / 2.).
-    Rotation::FromQuaternion(Rotation::QuaternionType(
-        0., 0., 0.7071067811865476, 0.7071067811865476)),
+    Rotation::FromNormalizedQuaternion(
+        Vector4(0., 0., kHalfSqrt2, kHalfSqrt2)),
     // LandscapeRight: This is the same than initializing the rotation from
     // Rotation::FromAxisAndAngle(Vector3(0., 0., 1.), -M_PI / 2.).
-    Rotation::FromQuaternion(Rotation::QuaternionType(
-        0., 0., -0.7071067811865476, 0.7071067811865476)),
+    Rotation::FromNormalizedQuaternion(
+        Vector4(0., 0., -kHalfSqrt2, kHalfSqrt2)),
     // Portrait: This is the same than initializing the rotation from
     // Rotation::FromAxisAndAngle(Vector3(0., 0., 1.), 0.).
-    Rotation::FromQuaternion(Rotation::QuaternionType(0., 0., 0., 1.)),
+    Rotation::FromNormalizedQuaternion(Vector4(0., 0., 0., 1.)),
     // PortaitUpsideDown: This is the same than initializing the rotation from
     // Rotation::FromAxisAndAngle(Vector3(0., 0., 1.), M_PI).
-    Rotation::FromQuaternion(Rotation::QuaternionType(0., 0., 1., 0.))};
-
-const std::array<std::array<Rotation, 4>, 4>
-    HeadTracker::kViewportChangeRotationCompensation{{
-        // Landscape left.
-        {Rotation::Identity(), Rotation::FromYawPitchRoll(0, 0, M_PI),
-         Rotation::FromYawPitchRoll(0, 0, -M_PI / 2),
-         Rotation::FromYawPitchRoll(0, 0, M_PI / 2)},
-        // Landscape Right.
-        {Rotation::FromYawPitchRoll(0, 0, M_PI), Rotation::Identity(),
-         Rotation::FromYawPitchRoll(0, 0, M_PI / 2),
-         Rotation::FromYawPitchRoll(0, 0, -M_PI / 2)},
-        // Portrait.
-        {Rotation::FromYawPitchRoll(0, 0, M_PI / 2),
-         Rotation::FromYawPitchRoll(0, 0, -M_PI / 2), Rotation::Identity(),
-         Rotation::FromYawPitchRoll(0, 0, M_PI)},
-        // Portrait Upside Down.
-        {Rotation::FromYawPitchRoll(0, 0, -M_PI / 2),
-         Rotation::FromYawPitchRoll(0, 0, M_PI / 2),
-         Rotation::FromYawPitchRoll(0, 0, M_PI), Rotation::Identity()},
-    }};
+    Rotation::FromNormalizedQuaternion(Vector4(0., 0., 1., 0.))};
+// @}
+
+// Returns the roll that compensates a change of the viewport orientation from
+// @p current to @p next, i.e. the difference of their sensor to display
+// rotations. The quaternion sign is chosen so that the roll is in (-pi, pi].
+constexpr Rotation ViewportChangeRotation(int current, int next) {
+  const Vector4 q =
+      (-kSensorToDisplayRotations[current] * kSensorToDisplayRotations[next])
+          .GetQuaternion();
+  const bool is_negated = q[3] < 0 || (q[3] == 0 && q[2] < 0);
+  return Rotation::FromNormalizedQuaternion(is_negated ? -q : q);
+}
+
+constexpr std::array<std::array<Rotation, 4>, 4>
+MakeViewportChangeRotationCompensation() {
+  std::array<std::array<Rotation, 4>, 4> compensation;
+  for (int current = 0; current < 4; ++current) {
+    for (int next = 0; next < 4; ++next) {
+      compensation[current][next] = ViewportChangeRotation(current, next);
+    }
+  }
+  return compensation;
+}
+
+// Contains the necessary rotations to account for changes in reported head
+// pose when the tracker starts/resets in a certain viewport and then changes
+// to another.
+//
+// The rows contain the current viewport orientation, the columns contain the
+// transformed viewport orientation. See below:
+//
+// @code
+// kViewportChangeRotationCompensation[current_viewport_orientation]
+//                                    [new_viewport_orientation]
+// @endcode
+//
+// Roll angle needs to change. The following table shows the correction angle
+// for each combination:
+//
+// | Current\New     | LL  | LR  |  P  | PUD |
+// |-----------------|-----|-----|-----|-----|
+// | Landscape Left  | 0   | π   |-π/2 | π/2 |
+// | Landscape Right | π   | 0   | π/2 |-π/2 |
+// | Portrait        | π/2 |-π/2 | 0   | π   |
+// | Portrait UD     |-π/2 | π/2 | π   | 0   |
+//
+// The table is composed at compile time from kSensorToDisplayRotations.
+constexpr std::array<std::array<Rotation, 4>, 4>
+    kViewportChangeRotationCompensation =
+        MakeViewportChangeRotationCompensation();
+
+}  // namespace
 
 HeadTracker::HeadTracker()
     : is_tracking_(false),
-      sensor_fusion_(new SensorFusionEkf()),
+      sensor_fusion_(new SensorFusionType()),
+      sensor_fusion_replay_(sensor_fusion_.get(), kReplaySamples,
+                            kReplayCheckpointInterval),
       latest_gyroscope_data_({0, 0, Vector3::Zero()}),
       accel_sensor_(new SensorEventProducer<AccelerometerData>()),
       gyro_sensor_(new SensorEventProducer<GyroscopeData>()),
+      is_viewport_orientation_initialized_(false),
       // Aryzon 6DoF
-      rotation_data_(new RotationData(kRotationSamples)),
       position_data_(new PositionData(kPositionSamples)),
-      is_viewport_orientation_initialized_(false) {
+      position_prediction_model_(kConstantVelocityPositionPrediction) {
   on_accel_callback_ = [&](const AccelerometerData& event) {
     OnAccelerometerData(event);
   };
   on_gyro_callback_ = [&](const GyroscopeData& event) {
     OnGyroscopeData(event);
   };
-  ekf_to_sixDoF_ = Rotation::Identity();
-  smooth_ekf_to_sixDoF_ = Rotation::Identity();
-  steady_start_ = Rotation::Identity();
-  steady_frames_ = -1;
 }
 
 HeadTracker::~HeadTracker() { UnregisterCallbacks(); }
@@ -135,33 +185,39 @@ void HeadTracker::GetPose(int64_t timestamp_ns,
 
   if (is_viewport_orientation_initialized_ &&
       viewport_orientation != viewport_orientation_) {
+      std::lock_guard<std::mutex> lock(sensor_fusion_mutex_);
       sensor_fusion_->RotateSensorSpaceToStartSpaceTransformation(
-                                                                  kViewportChangeRotationCompensation[viewport_orientation_]
-                                                                  [viewport_orientation]);
+          SensorFusionType::RotationType::Cast(
+              kViewportChangeRotationCompensation[viewport_orientation_]
+                                                 [viewport_orientation]));
+      // The checkpoints are relative to the previous start space.
+      sensor_fusion_replay_.Clear();
+      // The accelerations were rotated to the 6DoF world space through the
+      // previous start space.
+      position_kalman_filter_.Reset();
   }
   viewport_orientation_ = viewport_orientation;
   is_viewport_orientation_initialized_ = true;
     
-  const RotationState rotation_state = sensor_fusion_->GetLatestRotationState();
-  const Rotation unpredicted_rotation = rotation_state.sensor_from_start_rotation;
+  const SensorFusionType::RotationStateType rotation_state =
+      sensor_fusion_->GetLatestRotationState();
 
   const Rotation adjusted_rotation = GetRotation(viewport_orientation, timestamp_ns);
-  const Rotation adjusted_unpredicted_rotation = kSensorToDisplayRotations[viewport_orientation] * unpredicted_rotation * kEkfToHeadTrackerRotations[viewport_orientation];
-
-  // Save rotation sample with timestamp to be used in AddSixDoFData()
-  rotation_data_->AddSample(adjusted_unpredicted_rotation.GetQuaternion(), rotation_state.timestamp);
     
   if (position_data_->IsValid() && rotation_state.timestamp - position_data_->GetLatestTimestamp() < kMaxSixDoFTimeDifference) {
       
     // 6DoF is recently updated
-    const Vector4 orientation = (adjusted_rotation * smooth_ekf_to_sixDoF_).GetQuaternion();
+    const Vector4 orientation = adjusted_rotation.GetQuaternion();
       
     out_orientation[0] = static_cast<float>(orientation[0]);
     out_orientation[1] = static_cast<float>(orientation[1]);
     out_orientation[2] = static_cast<float>(orientation[2]);
     out_orientation[3] = static_cast<float>(orientation[3]);
       
-    Vector3 p = position_data_->GetExtrapolatedForTimeStamp(timestamp_ns);
+    Vector3 p;
+    if (position_prediction_model_ != kInertialPositionPrediction || !position_kalman_filter_.PredictPosition(timestamp_ns, &p)) {
+      p = position_data_->GetExtrapolatedForTimeStamp(timestamp_ns);
+    }
     out_position = {(float)p[0], (float)p[1], (float)p[2]};
   } else {
     // 6DoF is not recently updated
@@ -183,68 +239,82 @@ void HeadTracker::GetPose(int64_t timestamp_ns,
   }
 }
 
-Rotation ShortestRotation(Rotation a, Rotation b) {
-    
-    Vector4 aQ = a.GetQuaternion();
-    Vector4 bQ = b.GetQuaternion();
-    
-    if (Dot(aQ, bQ) < 0) {
-        return -a * Rotation::FromQuaternion(-bQ);
-    } else {
-        return -a * b;
-    }
-}
-
 // Aryzon 6DoF
 void HeadTracker::AddSixDoFData(int64_t timestamp_ns, float* pos, float* orientation) {
   if (!is_tracking_) {
     return;
   }
-    if (position_data_->GetLatestTimestamp() != timestamp_ns) {
-        position_data_->AddSample(Vector3(pos[0], pos[1], pos[2]), timestamp_ns);
+    const Rotation six_DoF_rotation = Rotation::FromQuaternion(Vector4(orientation[0], orientation[1], orientation[2], orientation[3]));
+    const PositionData::Model position_data_model = position_prediction_model_ == kConstantAccelerationPositionPrediction ? PositionData::Model::kConstantAcceleration : PositionData::Model::kConstantVelocity;
+    if (position_data_->GetModel() != position_data_model) {
+        position_data_->SetModel(position_data_model);
     }
+    if (position_data_->GetLatestTimestamp() == timestamp_ns) {
+        return;
+    }
+    position_data_->AddSample(Vector3(pos[0], pos[1], pos[2]), timestamp_ns);
+    sixdof_time_offset_estimator_.AddSixDoFOrientation(timestamp_ns, six_DoF_rotation);
     
-    // There will be a difference in rotation between ekf and sixDoF.
-    // SixDoF sensor is the 'truth' but is slower then ekf
-    // When the device is steady the difference between rotatations is saved
-    // smooth_ekf_to_sixDoF is slowly adjusted to smoothly close the gap
-    // between ekf and sixDoF. This value is used in GetPose().
-    
-    if (position_data_->IsValid() && rotation_data_->IsValid()) {
-        if ((steady_frames_ == 30 || steady_frames_ < 0) && rotation_data_->GetLatestTimeStamp() > timestamp_ns) {
-            // Match rotation timestamps of ekf to sixDoF by interpolating the saved ekf rotations
-            // 6DoF timestamp should be before the latest rotation_data timestamp otherwise extrapolation
-            // needs to happen which will be less accurate.
-            const Rotation ekf_at_time_of_sixDoF = Rotation::FromQuaternion(rotation_data_->GetInterpolatedForTimeStamp(timestamp_ns));
-            const Rotation six_DoF_rotation = Rotation::FromQuaternion(Vector4(orientation[0], orientation[1], orientation[2], orientation[3]));
-            
-            ekf_to_sixDoF_ = ShortestRotation(ekf_at_time_of_sixDoF, six_DoF_rotation);
-
-        } else if (steady_frames_ == 0) {
-             steady_start_ = Rotation::FromQuaternion(rotation_data_->GetLatestData());
-        }
-        
-        const Rotation steady_difference = steady_start_ * -Rotation::FromQuaternion(rotation_data_->GetLatestData());
-        
-        if (steady_difference.GetQuaternion()[3] > 0.9995) {
-            steady_frames_ += 1;
-        } else {
-            steady_frames_ = 0;
-        }
-        
-        const Rotation bias_to_fill =  ShortestRotation(smooth_ekf_to_sixDoF_, ekf_to_sixDoF_);
-        Vector3 axis;
-        double angle;
-        bias_to_fill.GetAxisAndAngle(&axis, &angle);
-        
-        const Rotation add_to_bias = Rotation::FromAxisAndAngle(axis, angle * kReduceBiasRate);
-        
-        smooth_ekf_to_sixDoF_ *= add_to_bias;
+    // The 6DoF orientation arrives tens of milliseconds after it was
+    // captured. It is a measurement update of the EKF at the capture time,
+    // which also observes the heading, and the IMU samples processed since
+    // are replayed, so that GetPose() follows it as soon as it arrives.
+    if (!is_viewport_orientation_initialized_) {
+        return;
     }
+    // The 6DoF timestamp is moved to the IMU clock, compensating the
+    // latency with which the 6DoF poses are stamped.
+    const int64_t imu_timestamp_ns = sixdof_time_offset_estimator_.ToImuTimestamp(timestamp_ns);
+    // GetRotation() returns kSensorToDisplayRotations * ekf * kEkfToHeadTrackerRotations,
+    // which is inverted to express the 6DoF orientation as an EKF rotation.
+    const CardboardViewportOrientation viewport_orientation = viewport_orientation_;
+    const Rotation sixDoF_sensor_from_start = -kSensorToDisplayRotations[viewport_orientation] * six_DoF_rotation * -kEkfToHeadTrackerRotations[viewport_orientation];
+    std::lock_guard<std::mutex> lock(sensor_fusion_mutex_);
+    sensor_fusion_replay_.ApplyRotationMeasurement(SensorFusionType::RotationType::Cast(sixDoF_sensor_from_start), imu_timestamp_ns);
+    // The position corrects the accelerations integrated since its capture
+    // in the same way.
+    position_kalman_filter_.AddPosition(imu_timestamp_ns, Vector3(pos[0], pos[1], pos[2]));
+}
+
+void HeadTracker::SetRotationPredictionModel(
+    CardboardRotationPredictionModel model) {
+  sensor_fusion_->SetRotationPredictionModel(
+      model == kConstantAccelerationPrediction
+          ? RotationPredictionModel::kConstantAcceleration
+          : RotationPredictionModel::kConstantVelocity);
+}
+
+void HeadTracker::SetGyroscopeBiasEstimation(
+    CardboardGyroscopeBiasEstimation estimation) {
+  std::lock_guard<std::mutex> lock(sensor_fusion_mutex_);
+  sensor_fusion_->SetGyroscopeBiasEstimation(
+      estimation == kFilterStateGyroscopeBiasEstimation
+          ? GyroscopeBiasEstimation::kFilterState
+          : GyroscopeBiasEstimation::kStaticDevice);
+  // A replay from a checkpoint saved before the switch would undo it, and
+  // the reset that comes with it.
+  sensor_fusion_replay_.Clear();
+}
+
+SixDoFTimeOffsetEstimator::Estimate HeadTracker::GetSixDoFTimeOffset() const {
+  return sixdof_time_offset_estimator_.GetEstimate();
+}
+
+SensorFusionReplayStatistics HeadTracker::GetSixDoFReplayStatistics() const {
+  std::lock_guard<std::mutex> lock(sensor_fusion_mutex_);
+  return sensor_fusion_replay_.GetStatistics();
+}
+
+void HeadTracker::SetPositionPredictionModel(
+    CardboardPositionPredictionModel model) {
+  position_prediction_model_ = model;
 }
 
 void HeadTracker::Recenter() {
+  std::lock_guard<std::mutex> lock(sensor_fusion_mutex_);
   sensor_fusion_->Reset();
+  // A replay from a checkpoint saved before the reset would undo it.
+  sensor_fusion_replay_.Clear();
 }
 
 void HeadTracker::RegisterCallbacks() {
@@ -261,7 +331,25 @@ void HeadTracker::OnAccelerometerData(const AccelerometerData& event) {
   if (!is_tracking_) {
     return;
   }
-  sensor_fusion_->ProcessAccelerometerSample(event);
+  std::lock_guard<std::mutex> lock(sensor_fusion_mutex_);
+  sensor_fusion_replay_.ProcessAccelerometerSample(event);
+
+  // Aryzon 6DoF
+  if (!is_viewport_orientation_initialized_ ||
+      !sensor_fusion_->IsAlignedWithGravity()) {
+    return;
+  }
+  // kEkfToHeadTrackerRotations maps the y up 6DoF world space to the z up
+  // start space, whose heading the 6DoF orientations set, so the sample is
+  // rotated to the world space by the inverse of sensor_from_start *
+  // kEkfToHeadTrackerRotations.
+  const Rotation sensor_from_world =
+      Rotation::Cast(
+          sensor_fusion_->GetLatestRotationState().sensor_from_start_rotation) *
+      kEkfToHeadTrackerRotations[viewport_orientation_];
+  position_kalman_filter_.AddAcceleration(
+      static_cast<int64_t>(event.system_timestamp),
+      -sensor_from_world * event.data - kSixDoFWorldGravity);
 }
 
 void HeadTracker::OnGyroscopeData(const GyroscopeData& event) {
@@ -269,14 +357,23 @@ void HeadTracker::OnGyroscopeData(const GyroscopeData& event) {
     return;
   }
   latest_gyroscope_data_ = event;
-  sensor_fusion_->ProcessGyroscopeSample(event);
+  {
+    std::lock_guard<std::mutex> lock(sensor_fusion_mutex_);
+    sensor_fusion_replay_.ProcessGyroscopeSample(event);
+  }
+
+  const SensorFusionType::RotationStateType rotation_state =
+      sensor_fusion_->GetLatestRotationState();
+  sixdof_time_offset_estimator_.AddAngularSpeed(
+      rotation_state.timestamp,
+      Length(rotation_state.sensor_from_start_rotation_velocity));
 }
 
 Rotation HeadTracker::GetRotation(
     CardboardViewportOrientation viewport_orientation,
     int64_t timestamp_ns) const {
   const Rotation predicted_rotation =
-      sensor_fusion_->PredictRotation(timestamp_ns);
+      Rotation::Cast(sensor_fusion_->PredictRotation(timestamp_ns));
 
   // In order to update our pose as the sensor changes, we begin with the
   // inverse default orientation (the orientation returned by a reset sensor,
@@ -17,6 +17,8 @@
 #define CARDBOARD_SDK_HEAD_TRACKER_H_
 
 #include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>  // NOLINT
 
@@ -25,11 +27,13 @@
 #include "sensors/gyroscope_data.h"
 #include "sensors/sensor_event_producer.h"
 #include "sensors/sensor_fusion_ekf.h"
+#include "sensors/sensor_fusion_replay.h"
 #include "util/rotation.h"
 
 // Aryzon 6DoF
-#include "sixdof/rotation_data.h"
 #include "sixdof/position_data.h"
+#include "sixdof/position_kalman_filter.h"
+#include "sixdof/time_offset_estimator.h"
 
 namespace cardboard {
 
@@ -61,6 +65,33 @@ class HeadTracker {
   // Aryzon 6DoF
   // @param event sensor event.
   void AddSixDoFData(int64_t timestamp_ns, float* position, float* orientation);
+
+  // Selects the motion model used to predict the rotation in GetPose(). It can
+  // be called from any thread.
+  //
+  // @param model the prediction model.
+  void SetRotationPredictionModel(CardboardRotationPredictionModel model);
+
+  // Selects how the gyroscope bias is estimated. It can be called from any
+  // thread and resets the sensor fusion.
+  //
+  // @param estimation the gyroscope bias estimation.
+  void SetGyroscopeBiasEstimation(CardboardGyroscopeBiasEstimation estimation);
+
+  // Selects the motion model used to predict the 6DoF position in GetPose().
+  // It can be called from any thread. The fitted models take effect with the
+  // next 6DoF sample.
+  //
+  // @param model the prediction model.
+  void SetPositionPredictionModel(CardboardPositionPredictionModel model);
+
+  // Returns the estimated offset between the 6DoF timestamps and the IMU
+  // clock. See SixDoFTimeOffsetEstimator.
+  SixDoFTimeOffsetEstimator::Estimate GetSixDoFTimeOffset() const;
+
+  // Returns the counts and costs of the replays that applied the 6DoF
+  // orientations to the sensor fusion. See SensorFusionReplay.
+  SensorFusionReplayStatistics GetSixDoFReplayStatistics() const;
     
  private:
   // Function called when receiving AccelerometerData.
@@ -86,9 +117,24 @@ class HeadTracker {
   Rotation GetRotation(CardboardViewportOrientation viewport_orientation,
                        int64_t timestamp_ns) const;
 
+  // Precision of the sensor fusion. Defining CARDBOARD_SDK_FLOAT_FUSION runs
+  // the EKF in single precision; the rotations below stay in double.
+#if defined(CARDBOARD_SDK_FLOAT_FUSION)
+  typedef FloatSensorFusionEkf SensorFusionType;
+#else
+  typedef SensorFusionEkf SensorFusionType;
+#endif
+
   std::atomic<bool> is_tracking_;
   // Sensor Fusion object that stores the internal state of the filter.
-  std::unique_ptr<SensorFusionEkf> sensor_fusion_;
+  std::unique_ptr<SensorFusionType> sensor_fusion_;
+  // Feeds the IMU samples to sensor_fusion_ and replays them when a 6DoF
+  // orientation is applied at its capture time.
+  SensorFusionReplay<SensorFusionType> sensor_fusion_replay_;
+  // Serializes the samples, the 6DoF orientations and the changes of the start
+  // space given to sensor_fusion_replay_ and sensor_fusion_, which come from
+  // the sensor, 6DoF and render threads.
+  mutable std::mutex sensor_fusion_mutex_;
   // Latest gyroscope data.
   GyroscopeData latest_gyroscope_data_;
 
@@ -101,58 +147,26 @@ class HeadTracker {
   std::function<void(AccelerometerData)> on_accel_callback_;
   std::function<void(GyroscopeData)> on_gyro_callback_;
 
-  // @{ Hold rotations to adapt the pose estimation to the viewport and head
-  // poses. Use the following indexing for each viewport orientation:
-  // [0]: Landscape left.
-  // [1]: Landscape right.
-  // [2]: Portrait.
-  // [3]: Portrait upside down.
-  static const std::array<Rotation, 4> kSensorToDisplayRotations;
-  static const std::array<Rotation, 4> kEkfToHeadTrackerRotations;
-  // @}
-
-  // Contains the necessary rotations to account for changes in reported head
-  // pose when the tracker starts/resets in a certain viewport and then changes
-  // to another.
-  //
-  // The rows contain the current viewport orientation, the columns contain the
-  // transformed viewport orientation. See below:
-  //
-  // @code
-  // kViewportChangeRotationCompensation[current_viewport_orientation]
-  //                                    [new_viewport_orientation]
-  // @endcode
-  //
-  // Roll angle needs to change. The following table shows the correction angle
-  // for each combination:
-  //
-  // | Current\New     | LL  | LR  |  P  | PUD |
-  // |-----------------|-----|-----|-----|-----|
-  // | Landscape Left  | 0   | π   |-π/2 | π/2 |
-  // | Landscape Right | π   | 0   | π/2 |-π/2 |
-  // | Portrait        | π/2 |-π/2 | 0   | π   |
-  // | Portrait UD     |-π/2 | π/2 | π   | 0   |
-  static const std::array<std::array<Rotation, 4>, 4>
-      kViewportChangeRotationCompensation;
-
   // Orientation of the viewport. It is initialized in the first call of
   // GetPose().
-  CardboardViewportOrientation viewport_orientation_;
+  std::atomic<CardboardViewportOrientation> viewport_orientation_;
 
   // Tells wheter the attribute viewport_orientation_ has been initialized or
   // not.
-  bool is_viewport_orientation_initialized_;
+  std::atomic<bool> is_viewport_orientation_initialized_;
     
   // Aryzon 6DoF
-  RotationData *rotation_data_;
+  // Written by the thread that adds the 6DoF samples. GetPose() reads the fit
+  // that it publishes.
   PositionData *position_data_;
-    
-  Rotation ekf_to_sixDoF_;
-  Rotation smooth_ekf_to_sixDoF_;
-  Rotation ekf_to_head_tracker_;
-  
-  float steady_frames_;
-  Rotation steady_start_;
+  // Position prediction model. The fitted models are applied to
+  // position_data_ with the next 6DoF sample, from the thread that adds them.
+  std::atomic<CardboardPositionPredictionModel> position_prediction_model_;
+  // Fuses the accelerometer with the 6DoF positions. Guarded by
+  // sensor_fusion_mutex_, except for the prediction.
+  PositionKalmanFilter position_kalman_filter_;
+  // Offset applied to the 6DoF timestamps to match them with the IMU samples.
+  SixDoFTimeOffsetEstimator sixdof_time_offset_estimator_;
 };
 
 }  // namespace cardboard
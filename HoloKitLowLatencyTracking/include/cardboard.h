@@ -66,6 +66,38 @@ typedef enum CardboardViewportOrientation {
   kPortraitUpsideDown = 3,
 } CardboardViewportOrientation;
 
+/// Enum to describe the motion models the head tracker can predict the head
+/// orientation with.
+typedef enum CardboardRotationPredictionModel {
+  /// The latest angular velocity is held over the whole prediction horizon.
+  kConstantVelocityPrediction = 0,
+  /// A smoothed angular acceleration is added, damped over long horizons.
+  kConstantAccelerationPrediction = 1,
+} CardboardRotationPredictionModel;
+
+/// Enum to describe how the head tracker estimates the gyroscope bias.
+typedef enum CardboardGyroscopeBiasEstimation {
+  /// The bias is measured while the device is static.
+  kStaticDeviceGyroscopeBiasEstimation = 0,
+  /// The bias is a state of the orientation filter, corrected by the
+  /// accelerometer while the device moves, and by the 6DoF orientations
+  /// around the gravity axis too.
+  kFilterStateGyroscopeBiasEstimation = 1,
+} CardboardGyroscopeBiasEstimation;
+
+/// Enum to describe the motion models the head tracker can extrapolate the 6DoF
+/// position with.
+typedef enum CardboardPositionPredictionModel {
+  /// A line is fitted to the recent 6DoF positions.
+  kConstantVelocityPositionPrediction = 0,
+  /// A parabola is fitted to the recent 6DoF positions.
+  kConstantAccelerationPositionPrediction = 1,
+  /// A Kalman filter integrates the accelerometer between the 6DoF positions,
+  /// which it applies at their capture time. The position is predicted at
+  /// constant velocity from its latest state.
+  kInertialPositionPrediction = 2,
+} CardboardPositionPredictionModel;
+
 /// Struct representing a 3D mesh with 3D vertices and corresponding UV
 /// coordinates.
 typedef struct CardboardMesh {
@@ -628,6 +660,72 @@ void CardboardHeadTracker_addSixDoFData(CardboardHeadTracker* head_tracker,
                                         float* position,
                                         float* orientation);
 
+/// Selects the motion model used to predict the head orientation at the
+/// timestamp passed to CardboardHeadTracker_getPose(). The default is
+/// kConstantVelocityPrediction.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      model                   The prediction model.
+void CardboardHeadTracker_setRotationPredictionModel(
+    CardboardHeadTracker* head_tracker, CardboardRotationPredictionModel model);
+
+/// Selects how the gyroscope bias is estimated. The default is
+/// kStaticDeviceGyroscopeBiasEstimation. Changing it resets the orientation
+/// filter.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      estimation              The gyroscope bias estimation.
+void CardboardHeadTracker_setGyroscopeBiasEstimation(
+    CardboardHeadTracker* head_tracker,
+    CardboardGyroscopeBiasEstimation estimation);
+
+/// Selects the motion model used to extrapolate the 6DoF position to the
+/// timestamp passed to CardboardHeadTracker_getPose(). The default is
+/// kConstantVelocityPositionPrediction. kInertialPositionPrediction uses the
+/// line fit until the filter has received its first 6DoF position. The fitted
+/// models take effect with the next 6DoF sample.
+///
+/// @pre @p head_tracker Must not be null.
+/// When it is unmet, a call to this function results in a no-op.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[in]      model                   The prediction model.
+void CardboardHeadTracker_setPositionPredictionModel(
+    CardboardHeadTracker* head_tracker, CardboardPositionPredictionModel model);
+
+/// Gets the estimated offset between the 6DoF timestamps passed to
+/// CardboardHeadTracker_addSixDoFData() and the clock of the IMU, which the
+/// head tracker adds to the 6DoF timestamps before matching the 6DoF
+/// orientations with its own. It is estimated while the head moves and is
+/// meant for telemetry.
+///
+/// @pre @p head_tracker Must not be null.
+/// @pre @p offset_ns Must not be null.
+/// @pre @p offset_stddev_ns Must not be null.
+/// @pre @p drift_ppm Must not be null.
+/// When it is unmet, a call to this function results in a no-op and 0 is
+/// returned.
+///
+/// @param[in]      head_tracker            Head tracker object pointer.
+/// @param[out]     offset_ns               Offset in nanoseconds, as of the
+///                                         latest estimate.
+/// @param[out]     offset_stddev_ns        Standard deviation of the offset
+///                                         in nanoseconds.
+/// @param[out]     drift_ppm               Drift of the offset in parts per
+///                                         million.
+/// @return 1 once the offset has been estimated, 0 otherwise, in which case
+///         the outputs are zero and the 6DoF timestamps are used as is.
+int CardboardHeadTracker_getSixDoFTimeOffset(CardboardHeadTracker* head_tracker,
+                                             int64_t* offset_ns,
+                                             int64_t* offset_stddev_ns,
+                                             float* drift_ppm);
+
 /// @}
 
 /////////////////////////////////////////////////////////////////////////////
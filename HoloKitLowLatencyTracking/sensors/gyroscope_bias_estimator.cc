@@ -231,17 +231,13 @@ Vector3 GyroscopeBiasEstimator::ComputeAngularVelocityFromLatestAccelerometer(
               last_mean_filtered_accelerometer_value_[2]),
       Vector3(mean_of_median[0], mean_of_median[1], mean_of_median[2]));
 
-  // We use axis angle here because this is how gyroscope values are stored.
-  Vector3 incremental_rotation_axis;
-  double incremental_rotation_angle;
-  incremental_rotation.GetAxisAndAngle(&incremental_rotation_axis,
-                                       &incremental_rotation_angle);
+  // We use the rotation vector here because this is how gyroscope values are
+  // stored.
+  const Vector3 angular_velocity = incremental_rotation.Log() / timestep;
 
-  incremental_rotation_axis *= incremental_rotation_angle / timestep;
-
-  return {static_cast<float>(incremental_rotation_axis[0]),
-          static_cast<float>(incremental_rotation_axis[1]),
-          static_cast<float>(incremental_rotation_axis[2])};
+  return {static_cast<float>(angular_velocity[0]),
+          static_cast<float>(angular_velocity[1]),
+          static_cast<float>(angular_velocity[2])};
 }
 
 bool GyroscopeBiasEstimator::UpdateGyroscopeBias(
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/gyroscope_integration.h"
+
+namespace cardboard {
+
+namespace {
+
+// Default gyroscope frequency. This corresponds to 100 Hz.
+const double kDefaultGyroscopeTimestep_s = 0.01f;
+// Maximum time between gyroscope before we start limiting the integration.
+const double kMaximumGyroscopeSampleDelay_s = 0.04f;
+// Timestep IIR filtering coefficient.
+const double kTimestepFilterCoeff = 0.95;
+// Minimum number of sample for timestep filtering.
+const int kTimestepFilterMinSamples = 10;
+
+}  // namespace
+
+GyroscopeTimestepFilter::GyroscopeTimestepFilter() { Reset(); }
+
+bool GyroscopeTimestepFilter::IsGap(double timestep_s) {
+  return timestep_s > kMaximumGyroscopeSampleDelay_s;
+}
+
+void GyroscopeTimestepFilter::AddTimestep(double timestep_s) {
+  if (!is_initialized_) {
+    // Initializes the filter.
+    filtered_timestep_s_ = timestep_s;
+    num_timestep_samples_ = 1;
+    is_initialized_ = true;
+    return;
+  }
+
+  // Computes the IIR filter response.
+  filtered_timestep_s_ = kTimestepFilterCoeff * filtered_timestep_s_ +
+                         (1 - kTimestepFilterCoeff) * timestep_s;
+  ++num_timestep_samples_;
+
+  if (num_timestep_samples_ > kTimestepFilterMinSamples) {
+    is_valid_ = true;
+  }
+}
+
+double GyroscopeTimestepFilter::GetFilteredTimestep() const {
+  return is_valid_ ? filtered_timestep_s_ : kDefaultGyroscopeTimestep_s;
+}
+
+void GyroscopeTimestepFilter::Reset() {
+  is_initialized_ = false;
+  is_valid_ = false;
+  filtered_timestep_s_ = kDefaultGyroscopeTimestep_s;
+  num_timestep_samples_ = 0;
+}
+
+}  // namespace cardboard
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_GYROSCOPE_INTEGRATION_H_
+#define CARDBOARD_SDK_SENSORS_GYROSCOPE_INTEGRATION_H_
+
+#include <cstdint>
+
+#include "util/rotation.h"
+#include "util/vector.h"
+
+namespace cardboard {
+
+// Computes a rotation matrix based on the integration of the gyroscope_value
+// over the @p timestep_s in seconds.
+//
+// @param gyroscope_value gyroscope sensor values.
+// @param timestep_s integration period in seconds.
+// @return Integration of the gyroscope value the rotation is from Start to
+//         Sensor Space.
+inline Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value,
+                                         double timestep_s) {
+  // Since the gyroscope_value is a start from sensor transformation we need to
+  // invert it to have a sensor from start transformation, hence the minus sign.
+  // For more info:
+  // - http://developer.android.com/guide/topics/sensors/sensors_motion.html#sensors-motion-gyro
+  // - https://developer.apple.com/documentation/coremotion/getting_raw_gyroscope_events
+  return Rotation::Exp(gyroscope_value * -timestep_s);
+}
+
+// Estimates the timestep between gyroscope samples, so that a sample that
+// follows a gap in the stream is integrated over a usual timestep rather than
+// over the whole gap.
+class GyroscopeTimestepFilter {
+ public:
+  GyroscopeTimestepFilter();
+
+  // Returns whether @p timestep_s, the time since the previous gyroscope
+  // sample, is a gap in the samples. Such timesteps are not filtered and
+  // should be integrated over GetFilteredTimestep() instead.
+  static bool IsGap(double timestep_s);
+
+  // Adds the time since the previous gyroscope sample to the filter.
+  //
+  // @param timestep_s timestep in seconds, which is not a gap.
+  void AddTimestep(double timestep_s);
+
+  // Returns the filtered timestep, or a default of 10 ms until enough
+  // timesteps have been filtered.
+  double GetFilteredTimestep() const;
+
+  // Resets the filter state.
+  void Reset();
+
+ private:
+  // Filtering of the gyroscope timestep started?
+  bool is_initialized_;
+  // Filtered gyroscope timestep valid?
+  bool is_valid_;
+  // Estimates of the timestep between gyroscope event in seconds.
+  double filtered_timestep_s_;
+  // Number of timestep samples processed so far by the filter.
+  uint32_t num_timestep_samples_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_GYROSCOPE_INTEGRATION_H_
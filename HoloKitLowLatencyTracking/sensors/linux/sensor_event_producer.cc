@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/sensor_event_producer.h"
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "sensors/accelerometer_data.h"
+#include "sensors/gyroscope_data.h"
+#include "sensors/linux/trace_player.h"
+#include "sensors/sensor_trace.h"
+#include "sensors/sixdof_data.h"
+#include "util/logging.h"
+
+// Host implementation of SensorEventProducer. Instead of polling device
+// sensors it replays the trace installed with TracePlayer::SetTrace().
+
+namespace cardboard {
+
+template <typename DataType>
+struct SensorEventProducer<DataType>::EventProducer {
+  EventProducer() : run_thread(false), next_sample(0), stream_id(-1) {}
+
+  // Capture thread running WorkFn.
+  std::unique_ptr<std::thread> capture_thread;
+  // Flag indicating if the capture thread should run.
+  std::atomic<bool> run_thread;
+  // Serializes StartSensorPolling and StopSensorPolling.
+  std::mutex mutex;
+
+  // Trace being replayed and index of the next sample to deliver. Polling
+  // resumes where it stopped unless a different trace was installed.
+  std::shared_ptr<const SensorTrace> trace;
+  size_t next_sample;
+  // Id of the stream registered with the TracePlayer while polling.
+  int stream_id;
+
+  // Returns the timestamp of the sample at @p index, or
+  // TracePlayer::kEndOfStream past the last sample.
+  int64_t GetTimestamp(size_t index) const {
+    const std::vector<DataType>& samples =
+        trace->template GetSamples<DataType>();
+    return index < samples.size()
+               ? static_cast<int64_t>(samples[index].sensor_timestamp_ns)
+               : TracePlayer::kEndOfStream;
+  }
+};
+
+template <typename DataType>
+SensorEventProducer<DataType>::SensorEventProducer()
+    : event_producer_(new EventProducer()), on_event_callback_(nullptr) {}
+
+template <typename DataType>
+SensorEventProducer<DataType>::~SensorEventProducer() {
+  StopSensorPolling();
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StartSensorPolling(
+    const std::function<void(DataType)>* on_event_callback) {
+  std::unique_lock<std::mutex> lock(event_producer_->mutex);
+  on_event_callback_ = on_event_callback;
+  StartSensorPollingLocked();
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StopSensorPolling() {
+  std::unique_lock<std::mutex> lock(event_producer_->mutex);
+  StopSensorPollingLocked();
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StartSensorPollingLocked() {
+  // If the thread is started already there is nothing left to do.
+  if (event_producer_->run_thread.exchange(true)) {
+    return;
+  }
+
+  std::shared_ptr<const SensorTrace> trace = TracePlayer::GetTrace();
+  if (!trace) {
+    CARDBOARD_LOGE("No sensor trace installed, sensor polling not started.\n");
+    event_producer_->run_thread = false;
+    return;
+  }
+  if (trace != event_producer_->trace) {
+    event_producer_->trace = trace;
+    event_producer_->next_sample = 0;
+  }
+
+  // Registering here rather than on the capture thread guarantees the stream
+  // holds back the others as soon as polling is requested.
+  event_producer_->stream_id = TracePlayer::RegisterStream(
+      event_producer_->GetTimestamp(event_producer_->next_sample));
+  event_producer_->capture_thread.reset(
+      new std::thread(&SensorEventProducer<DataType>::WorkFn, this));
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::StopSensorPollingLocked() {
+  // If the thread is already stopped nothing needs to be done.
+  if (!event_producer_->run_thread.exchange(false)) {
+    return;
+  }
+
+  if (event_producer_->capture_thread->joinable()) {
+    event_producer_->capture_thread->join();
+  }
+  event_producer_->capture_thread.reset();
+  TracePlayer::UnregisterStream(event_producer_->stream_id);
+}
+
+template <typename DataType>
+void SensorEventProducer<DataType>::WorkFn() {
+  const std::vector<DataType>& samples =
+      event_producer_->trace->template GetSamples<DataType>();
+  size_t& next_sample = event_producer_->next_sample;
+  const int stream_id = event_producer_->stream_id;
+
+  while (event_producer_->run_thread) {
+    if (next_sample >= samples.size()) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(kMaxWaitMilliseconds));
+      continue;
+    }
+
+    const int64_t timestamp_ns = event_producer_->GetTimestamp(next_sample);
+    if (!TracePlayer::WaitForTurn(stream_id, timestamp_ns,
+                                  kMaxWaitMilliseconds)) {
+      continue;
+    }
+
+    // Recorded timestamps are already in system time.
+    DataType event = samples[next_sample++];
+    if (on_event_callback_) {
+      (*on_event_callback_)(event);
+    }
+    TracePlayer::Advance(stream_id, timestamp_ns,
+                         event_producer_->GetTimestamp(next_sample));
+  }
+}
+
+// Forcing instantiation of SensorEventProducer for each sensor type.
+template class SensorEventProducer<AccelerometerData>;
+template class SensorEventProducer<GyroscopeData>;
+template class SensorEventProducer<SixDoFData>;
+
+}  // namespace cardboard
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/linux/trace_player.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <map>
+#include <mutex>  // NOLINT
+
+namespace cardboard {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PlayerState {
+  std::mutex mutex;
+  std::condition_variable condition;
+
+  std::shared_ptr<const SensorTrace> trace;
+  double playback_rate = 1.0;
+  // Timestamp of the first sample of the trace.
+  int64_t trace_start_ns = 0;
+
+  // Wall clock time at which the trace start is replayed.
+  Clock::time_point epoch;
+  bool is_started = false;
+
+  // Timestamp of the next sample of each registered stream.
+  std::map<int, int64_t> pending_timestamps;
+  int next_stream_id = 0;
+  bool has_registered_streams = false;
+
+  // Timestamp of the latest delivered sample of any stream.
+  int64_t latest_delivered_ns = 0;
+};
+
+PlayerState& GetState() {
+  static PlayerState* state = new PlayerState();
+  return *state;
+}
+
+// Returns true if no other stream has a pending sample before
+// @p timestamp_ns. The lock must be held.
+bool IsEarliestPendingLocked(const PlayerState& state, int stream_id,
+                             int64_t timestamp_ns) {
+  for (const auto& pending : state.pending_timestamps) {
+    if (pending.first != stream_id && pending.second < timestamp_ns) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the wall clock time at which @p timestamp_ns is due. The lock must
+// be held and the replay must be paced.
+Clock::time_point GetDueTimeLocked(const PlayerState& state,
+                                   int64_t timestamp_ns) {
+  const double offset_ns =
+      static_cast<double>(timestamp_ns - state.trace_start_ns) /
+      state.playback_rate;
+  return state.epoch + std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<double, std::nano>(offset_ns));
+}
+
+}  // namespace
+
+void TracePlayer::SetTrace(std::shared_ptr<const SensorTrace> trace,
+                           double playback_rate) {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.trace = std::move(trace);
+  state.playback_rate = playback_rate;
+  state.trace_start_ns = state.trace ? state.trace->GetStartTimestamp() : 0;
+  state.is_started = false;
+  state.has_registered_streams = false;
+  state.latest_delivered_ns = state.trace_start_ns;
+  state.condition.notify_all();
+}
+
+void TracePlayer::Start() {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.epoch = Clock::now();
+  state.is_started = true;
+  state.condition.notify_all();
+}
+
+std::shared_ptr<const SensorTrace> TracePlayer::GetTrace() {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  return state.trace;
+}
+
+int64_t TracePlayer::GetCurrentTimestamp() {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  if (state.playback_rate <= 0 || !state.is_started) {
+    return state.latest_delivered_ns;
+  }
+  const double elapsed_ns =
+      std::chrono::duration<double, std::nano>(Clock::now() - state.epoch)
+          .count();
+  return state.trace_start_ns +
+         static_cast<int64_t>(elapsed_ns * state.playback_rate);
+}
+
+bool TracePlayer::IsFinished() {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  if (!state.has_registered_streams) {
+    return false;
+  }
+  return std::all_of(state.pending_timestamps.begin(),
+                     state.pending_timestamps.end(), [](const auto& pending) {
+                       return pending.second == kEndOfStream;
+                     });
+}
+
+int TracePlayer::RegisterStream(int64_t next_timestamp_ns) {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  const int stream_id = state.next_stream_id++;
+  state.pending_timestamps[stream_id] = next_timestamp_ns;
+  state.has_registered_streams = true;
+  return stream_id;
+}
+
+void TracePlayer::UnregisterStream(int stream_id) {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.pending_timestamps.erase(stream_id);
+  state.condition.notify_all();
+}
+
+bool TracePlayer::WaitForTurn(int stream_id, int64_t timestamp_ns,
+                              int timeout_ms) {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  const Clock::time_point deadline =
+      Clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (true) {
+    if (!state.is_started ||
+        !IsEarliestPendingLocked(state, stream_id, timestamp_ns)) {
+      if (state.condition.wait_until(lock, deadline) ==
+          std::cv_status::timeout) {
+        return false;
+      }
+      continue;
+    }
+    if (state.playback_rate > 0) {
+      const Clock::time_point due = GetDueTimeLocked(state, timestamp_ns);
+      if (Clock::now() < due) {
+        if (due > deadline) {
+          state.condition.wait_until(lock, deadline);
+          return false;
+        }
+        state.condition.wait_until(lock, due);
+        continue;
+      }
+    }
+    return true;
+  }
+}
+
+void TracePlayer::Advance(int stream_id, int64_t delivered_timestamp_ns,
+                          int64_t next_timestamp_ns) {
+  PlayerState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.mutex);
+  state.pending_timestamps[stream_id] = next_timestamp_ns;
+  state.latest_delivered_ns =
+      std::max(state.latest_delivered_ns, delivered_timestamp_ns);
+  state.condition.notify_all();
+}
+
+}  // namespace cardboard
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_LINUX_TRACE_PLAYER_H_
+#define CARDBOARD_SDK_SENSORS_LINUX_TRACE_PLAYER_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "sensors/sensor_trace.h"
+
+namespace cardboard {
+
+// Replay clock shared by the trace based SensorEventProducer backend.
+//
+// Every SensorEventProducer polls its own sample type from the installed
+// trace on its own thread, like the device sensors do. The player keeps the
+// streams merged in timestamp order, so a callback for a sample only runs once
+// the callbacks of all earlier samples of the other streams have returned, and
+// paces them against the wall clock when a positive playback rate is set.
+//
+// Nothing is delivered before Start() is called, which lets all consumers
+// start polling first so that no stream runs ahead of the others.
+//
+// This class is thread-safe.
+class TracePlayer {
+ public:
+  // Value used as next timestamp by streams that have no samples left.
+  static constexpr int64_t kEndOfStream = INT64_MAX;
+
+  // Installs the trace replayed by SensorEventProducers started afterwards
+  // and stops the replay clock until the next Start() call. Producers that
+  // are already polling keep replaying the trace they started with.
+  //
+  // @param trace trace to replay. May be nullptr to stop providing data.
+  // @param playback_rate 1 replays in real time, 2 twice as fast and so on.
+  //        Zero or a negative value replays as fast as the callbacks allow.
+  static void SetTrace(std::shared_ptr<const SensorTrace> trace,
+                       double playback_rate);
+
+  // Starts the replay clock at the first sample of the trace.
+  static void Start();
+
+  // Returns the installed trace, or nullptr if none is installed.
+  static std::shared_ptr<const SensorTrace> GetTrace();
+
+  // Returns the current replay time on the trace clock in nanoseconds. When
+  // replaying as fast as possible this is the timestamp of the latest
+  // delivered sample.
+  static int64_t GetCurrentTimestamp();
+
+  // Returns true once at least one stream was registered and all registered
+  // streams delivered their last sample.
+  static bool IsFinished();
+
+  // @{ Stream coordination used by SensorEventProducer.
+  //
+  // Registers a stream whose next sample is at @p next_timestamp_ns and
+  // returns its id.
+  static int RegisterStream(int64_t next_timestamp_ns);
+
+  // Unregisters a stream so that it no longer holds the others back.
+  static void UnregisterStream(int stream_id);
+
+  // Blocks up to @p timeout_ms until the replay is started, the sample at
+  // @p timestamp_ns is the earliest pending sample of all streams and, when
+  // pacing, until it is due.
+  //
+  // @return true if the sample can be delivered now.
+  static bool WaitForTurn(int stream_id, int64_t timestamp_ns, int timeout_ms);
+
+  // Marks the pending sample of a stream as delivered.
+  //
+  // @param delivered_timestamp_ns timestamp of the delivered sample.
+  // @param next_timestamp_ns timestamp of the next sample of the stream, or
+  //        kEndOfStream.
+  static void Advance(int stream_id, int64_t delivered_timestamp_ns,
+                      int64_t next_timestamp_ns);
+  // @}
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_LINUX_TRACE_PLAYER_H_
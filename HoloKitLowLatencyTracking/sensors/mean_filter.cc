@@ -15,27 +15,48 @@
  */
 #include "sensors/mean_filter.h"
 
+#include <algorithm>
+
 namespace cardboard {
 
-MeanFilter::MeanFilter(size_t filter_size) : filter_size_(filter_size) {}
+namespace {
+
+// Minimum number of added samples between exact recomputations of the running
+// sum. Larger windows resync once per window, keeping the amortized cost of a
+// resync below one addition per sample.
+constexpr size_t kMinResyncInterval = 1024;
+
+}  // namespace
+
+MeanFilter::MeanFilter(size_t filter_size)
+    : buffer_(filter_size),
+      sum_(Vector3::Zero()),
+      samples_since_resync_(0),
+      resync_interval_(std::max(filter_size, kMinResyncInterval)) {}
 
 void MeanFilter::AddSample(const Vector3& sample) {
-  buffer_.push_back(sample);
-  if (buffer_.size() > filter_size_) {
-    buffer_.pop_front();
+  if (buffer_.IsFull()) {
+    sum_ -= buffer_.Front();
   }
-}
+  buffer_.Push(sample);
 
-bool MeanFilter::IsValid() const { return buffer_.size() == filter_size_; }
+  if (++samples_since_resync_ < resync_interval_) {
+    sum_ += sample;
+    return;
+  }
 
-Vector3 MeanFilter::GetFilteredData() const {
-  // Compute mean of the samples stored in buffer_.
-  Vector3 mean = Vector3::Zero();
-  for (auto sample : buffer_) {
-    mean += sample;
+  // Recompute the sum of the samples stored in buffer_.
+  sum_ = Vector3::Zero();
+  for (size_t i = 0; i < buffer_.Size(); ++i) {
+    sum_ += buffer_[i];
   }
+  samples_since_resync_ = 0;
+}
 
-  return mean / static_cast<double>(filter_size_);
+bool MeanFilter::IsValid() const { return buffer_.IsFull(); }
+
+Vector3 MeanFilter::GetFilteredData() const {
+  return sum_ / static_cast<double>(buffer_.Capacity());
 }
 
 }  // namespace cardboard
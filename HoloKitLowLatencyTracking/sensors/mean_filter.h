@@ -16,8 +16,9 @@
 #ifndef CARDBOARD_SDK_SENSORS_MEAN_FILTER_H_
 #define CARDBOARD_SDK_SENSORS_MEAN_FILTER_H_
 
-#include <deque>
+#include <cstddef>
 
+#include "util/ring_buffer.h"
 #include "util/vector.h"
 
 namespace cardboard {
@@ -35,12 +36,19 @@ class MeanFilter {
   // Returns true if buffer has filter_size_ sample, false otherwise.
   bool IsValid() const;
 
-  // Returns the mean of values stored in the internal buffer.
+  // Returns the mean of values stored in the internal buffer. This is O(1) in
+  // the filter size.
   Vector3 GetFilteredData() const;
 
  private:
-  const size_t filter_size_;
-  std::deque<Vector3> buffer_;
+  RingBuffer<Vector3> buffer_;
+  // Sum of the samples in buffer_, updated on every add and evict.
+  Vector3 sum_;
+  // Number of samples added since sum_ was last recomputed from buffer_.
+  size_t samples_since_resync_;
+  // Number of added samples after which sum_ is recomputed, bounding the
+  // floating point drift of the running sum.
+  const size_t resync_interval_;
 };
 
 }  // namespace cardboard
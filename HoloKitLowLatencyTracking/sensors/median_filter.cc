@@ -16,49 +16,87 @@
 #include "sensors/median_filter.h"
 
 #include <algorithm>
-#include <vector>
+#include <utility>
 
 #include "util/vector.h"
 #include "util/vectorutils.h"
 
 namespace cardboard {
 
-MedianFilter::MedianFilter(size_t filter_size) : filter_size_(filter_size) {}
+namespace {
 
-void MedianFilter::AddSample(const Vector3& sample) {
-  buffer_.push_back(sample);
-  norms_.push_back(Length(sample));
-  if (buffer_.size() > filter_size_) {
-    buffer_.pop_front();
-    norms_.pop_front();
+// Window size served by the sorting network in GetMedianIndexOfFive().
+constexpr size_t kNetworkWindowSize = 5;
+
+// Norm of a sample together with its position in the filter buffer.
+struct IndexedNorm {
+  float norm;
+  size_t index;
+};
+
+// Orders @p a and @p b by norm.
+inline void CompareAndSwap(IndexedNorm& a, IndexedNorm& b) {
+  if (b.norm < a.norm) {
+    std::swap(a, b);
   }
 }
 
-bool MedianFilter::IsValid() const { return buffer_.size() == filter_size_; }
+// Returns the index of the element whose norm is the median of the five
+// @p norms, using a fixed 7 comparator selection network.
+size_t GetMedianIndexOfFive(IndexedNorm norms[kNetworkWindowSize]) {
+  CompareAndSwap(norms[0], norms[1]);
+  CompareAndSwap(norms[3], norms[4]);
+  CompareAndSwap(norms[0], norms[3]);
+  CompareAndSwap(norms[1], norms[4]);
+  CompareAndSwap(norms[1], norms[2]);
+  CompareAndSwap(norms[2], norms[3]);
+  CompareAndSwap(norms[1], norms[2]);
+  return norms[2].index;
+}
+
+}  // namespace
+
+MedianFilter::MedianFilter(size_t filter_size)
+    : filter_size_(filter_size),
+      buffer_(filter_size),
+      sorted_norms_(filter_size) {}
+
+void MedianFilter::AddSample(const Vector3& sample) {
+  buffer_.Push({sample, static_cast<float>(Length(sample))});
+}
+
+bool MedianFilter::IsValid() const { return buffer_.IsFull(); }
 
 Vector3 MedianFilter::GetFilteredData() const {
-  std::vector<float> norms(norms_.begin(), norms_.end());
+  const size_t size = buffer_.Size();
+  if (filter_size_ == kNetworkWindowSize && size == kNetworkWindowSize) {
+    IndexedNorm norms[kNetworkWindowSize];
+    for (size_t i = 0; i < kNetworkWindowSize; ++i) {
+      norms[i] = {buffer_[i].norm, i};
+    }
+    return buffer_[GetMedianIndexOfFive(norms)].value;
+  }
+
+  // General path for other window sizes.
+  for (size_t i = 0; i < size; ++i) {
+    sorted_norms_[i] = buffer_[i].norm;
+  }
 
   // Get median of value of the norms.
-  std::nth_element(norms.begin(), norms.begin() + filter_size_ / 2,
-                   norms.end());
-  const float median_norm = norms[filter_size_ / 2];
+  std::nth_element(sorted_norms_.begin(),
+                   sorted_norms_.begin() + filter_size_ / 2,
+                   sorted_norms_.begin() + size);
+  const float median_norm = sorted_norms_[filter_size_ / 2];
 
   // Get median value based on their norm.
-  auto median_it = buffer_.begin();
-  for (const auto norm : norms_) {
-    if (norm == median_norm) {
-      break;
-    }
-    ++median_it;
+  size_t median_index = 0;
+  while (median_index + 1 < size && buffer_[median_index].norm != median_norm) {
+    ++median_index;
   }
 
-  return *median_it;
+  return buffer_[median_index].value;
 }
 
-void MedianFilter::Reset() {
-  buffer_.clear();
-  norms_.clear();
-}
+void MedianFilter::Reset() { buffer_.Clear(); }
 
 }  // namespace cardboard
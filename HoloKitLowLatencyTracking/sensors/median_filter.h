@@ -16,8 +16,10 @@
 #ifndef CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 #define CARDBOARD_SDK_SENSORS_MEDIAN_FILTER_H_
 
-#include <deque>
+#include <cstddef>
+#include <vector>
 
+#include "util/ring_buffer.h"
 #include "util/vector.h"
 
 namespace cardboard {
@@ -36,16 +38,25 @@ class MedianFilter {
   bool IsValid() const;
 
   // Returns the median of values store in the internal buffer.
+  // A window of 5 samples is served by a fixed sorting network, other sizes
+  // fall back to a partial sort. Neither allocates.
   Vector3 GetFilteredData() const;
 
   // Resets the filter, removing all samples that have been added.
   void Reset();
 
  private:
+  struct Sample {
+    Vector3 value;
+    // Norm of value, computed once when the sample is added.
+    float norm;
+  };
+
   const size_t filter_size_;
-  std::deque<Vector3> buffer_;
-  // Contains norms of the elements stored in buffer_.
-  std::deque<float> norms_;
+  RingBuffer<Sample> buffer_;
+  // Scratch space for the general median selection, sized once at
+  // construction.
+  mutable std::vector<float> sorted_norms_;
 };
 
 }  // namespace cardboard
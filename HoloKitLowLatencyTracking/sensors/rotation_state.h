@@ -16,25 +16,36 @@
 #ifndef CARDBOARD_SDK_SENSORS_ROTATION_STATE_H_
 #define CARDBOARD_SDK_SENSORS_ROTATION_STATE_H_
 
+#include <cstdint>
+
 #include "util/rotation.h"
 #include "util/vector.h"
 
 namespace cardboard {
 
-// Stores a rotation and the angular velocity measured in the sensor space.
-// It can be used for prediction.
-struct RotationState {
+// Stores a rotation and the angular velocity and acceleration measured in the
+// sensor space. It can be used for prediction. Use the RotationState (double)
+// and RotationStatef (float) typedefs.
+template <typename Scalar>
+struct BasicRotationState {
   // System wall time. It is measured in nanoseconds.
   int64_t timestamp;
 
   // Rotation from Sensor Space to Start Space. It is measured in radians (rad).
-  Rotation sensor_from_start_rotation;
+  BasicRotation<Scalar> sensor_from_start_rotation;
 
   // First derivative of the rotation. It is measured in radians per second
   // (rad/s).
-  Vector3 sensor_from_start_rotation_velocity;
+  Vector<3, Scalar> sensor_from_start_rotation_velocity;
+
+  // Second derivative of the rotation, smoothed over the recent gyroscope
+  // samples. It is measured in radians per second squared (rad/s^2).
+  Vector<3, Scalar> sensor_from_start_rotation_acceleration;
 };
 
+typedef BasicRotationState<double> RotationState;
+typedef BasicRotationState<float> RotationStatef;
+
 }  // namespace cardboard
 
 #endif  // CARDBOARD_SDK_SENSORS_ROTATION_STATE_H_
@@ -20,6 +20,7 @@
 
 #include "sensors/accelerometer_data.h"
 #include "sensors/gyroscope_data.h"
+#include "sensors/gyroscope_integration.h"
 #include "util/logging.h"
 #include "util/matrixutils.h"
 
@@ -28,11 +29,12 @@ namespace cardboard {
 namespace {
 
 const double kFiniteDifferencingEpsilon = 1e-7;
-const double kEpsilon = 1e-15;
-// Default gyroscope frequency. This corresponds to 100 Hz.
-const double kDefaultGyroscopeTimestep_s = 0.01f;
-// Maximum time between gyroscope before we start limiting the integration.
-const double kMaximumGyroscopeSampleDelay_s = 0.04f;
+// Below this sine of the innovation angle, the closed form measurement
+// Jacobian switches to its Taylor expansion.
+const double kSmallInnovationSine = 1e-4;
+// Smallest pivot of the innovation covariance factorization, relative to its
+// largest diagonal element, for which the accelerometer update is applied.
+const double kMinInnovationCovariancePivotRatio = 1e-12;
 // Compute a first-order exponential moving average of changes in accel norm per
 // frame.
 const double kSmoothingFactor = 0.5;
@@ -47,51 +49,40 @@ const double kInitialProcessCovarianceValue = 1.0;
 // Maximum accelerometer norm change allowed before capping it covariance to a
 // large value.
 const double kMaxAccelNormChange = 0.15;
-// Timestep IIR filtering coefficient.
-const double kTimestepFilterCoeff = 0.95;
-// Minimum number of sample for timestep filtering.
-const int kTimestepFilterMinSamples = 10;
+// Standard deviation of the rotation measurements in radians. It covers the
+// noise of the external tracker and the error of the timestamp matching its
+// measurements with the IMU samples.
+const double kRotationMeasurementStdDev = 0.02;
+// Rotation measurements further than this angle from the estimate replace it,
+// as the external tracker has relocalized or this is its first measurement.
+const double kMaxRotationInnovation = 0.2;
+// Initial standard deviation of the gyroscope bias when it is a state of the
+// filter, in rad/s, and its random walk, in rad/s/sqrt(s).
+const double kInitialGyroscopeBiasStdDev = 0.05;
+const double kGyroscopeBiasRandomWalk = 1e-3;
+// Time constant of the low-pass filter applied to the angular acceleration,
+// which is a finite difference of noisy gyroscope samples.
+const double kAngularAccelerationFilterTime_s = 0.02;
+// Time constant of the decay assumed for the angular acceleration by the
+// constant acceleration prediction model. This bounds the velocity it adds to
+// the acceleration times this time, whatever the prediction horizon.
+const double kAngularAccelerationDecayTime_s = 0.03;
 
 // Z direction in start space.
 const Vector3 kCanonicalZDirection(0.0, 0.0, 1.0);
 
-// Computes a axis angle rotation from the input vector.
-// angle = norm(a)
-// axis = a.normalized()
-// If norm(a) == 0, it returns an identity rotation.
-Rotation RotationFromVector(const Vector3& a) {
-  const double norm_a = Length(a);
-  if (norm_a < kEpsilon) {
-    return Rotation::Identity();
+// Returns the mean angular velocity added over a prediction of @p horizon_s
+// by a unit angular acceleration decaying with kAngularAccelerationDecayTime_s.
+// Over the horizon t, an acceleration decaying as exp(-s / tau) sweeps the
+// angle tau * (t - tau * (1 - exp(-t / tau))), which is t^2 / 2 for short
+// horizons and only grows linearly for long ones.
+double GetAngularAccelerationPredictionTime(double horizon_s) {
+  const double x = std::abs(horizon_s) / kAngularAccelerationDecayTime_s;
+  if (x < 1e-6) {
+    return 0.5 * horizon_s;
   }
-  return Rotation::FromAxisAndAngle(a / norm_a, norm_a);
-}
-
-// Computes a rotation matrix based on the integration of the gyroscope_value
-// over the @p timestep_s in seconds.
-//
-// @param gyroscope_value gyroscope sensor values.
-// @param timestep_s integration period in seconds.
-// @return Integration of the gyroscope value the rotation is from Start to
-//         Sensor Space.
-Rotation GetRotationFromGyroscope(const Vector3& gyroscope_value,
-                                  double timestep_s) {
-  const double velocity = Length(gyroscope_value);
-
-  // When there is no rotation data return an identity rotation.
-  if (velocity < kEpsilon) {
-    CARDBOARD_LOGI(
-        "PosePrediction::GetRotationFromGyroscope: Velocity really small, "
-        "returning identity rotation.");
-    return Rotation::Identity();
-  }
-  // Since the gyroscope_value is a start from sensor transformation we need to
-  // invert it to have a sensor from start transformation, hence the minus sign.
-  // For more info:
-  // - http://developer.android.com/guide/topics/sensors/sensors_motion.html#sensors-motion-gyro
-  // - https://developer.apple.com/documentation/coremotion/getting_raw_gyroscope_events
-  return Rotation::FromAxisAndAngle(gyroscope_value / velocity,
-                                    -timestep_s * velocity);
+  return std::copysign(
+      kAngularAccelerationDecayTime_s * (1.0 + std::expm1(-x) / x), horizon_s);
 }
 
 // Returns the difference of @p timestamp_ns_a and @p timestamp_ns_b in
@@ -103,78 +94,281 @@ constexpr double ComputeTimeDifferenceInSeconds(int64_t timestamp_ns_a,
 
 }  // namespace
 
-SensorFusionEkf::SensorFusionEkf()
+template <typename Scalar>
+BasicSensorFusionEkf<Scalar>::BasicSensorFusionEkf()
     : execute_reset_with_next_accelerometer_sample_(false),
-      gyroscope_bias_estimate_({0, 0, 0}) {
+      is_replaying_(false),
+      rotation_prediction_model_(RotationPredictionModel::kConstantVelocity),
+      gyroscope_bias_estimate_({0, 0, 0}),
+      gyroscope_bias_estimation_(GyroscopeBiasEstimation::kStaticDevice),
+      is_gyroscope_bias_in_state_(false),
+      rotation_bias_covariance_(MatrixType::Zero()),
+      gyroscope_bias_covariance_(SymmetricMatrixType::Zero()),
+      is_measurement_jacobian_check_enabled_(false),
+      max_measurement_jacobian_error_(0.0) {
   ResetState();
 }
 
-void SensorFusionEkf::Reset() {
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::Reset() {
   execute_reset_with_next_accelerometer_sample_ = true;
 }
 
-void SensorFusionEkf::RotateSensorSpaceToStartSpaceTransformation(
-    const Rotation& rotation) {
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::RotateSensorSpaceToStartSpaceTransformation(
+    const RotationType& rotation) {
+  std::unique_lock<std::mutex> lock(mutex_);
   current_state_.sensor_from_start_rotation *= rotation;
+  PublishState();
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::ProcessRotationMeasurement(
+    const RotationType& sensor_from_start_rotation, int64_t timestamp) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!is_aligned_with_gravity_) {
+    return;
+  }
+  // The measurement is the current rotation integrated up to its timestamp,
+  // so it is compared with the current rotation once integrated back.
+  const double timestep_s =
+      ComputeTimeDifferenceInSeconds(timestamp, current_state_.timestamp);
+  const Rotation update = GetRotationFromGyroscope(
+      Vector3(current_state_.sensor_from_start_rotation_velocity), timestep_s);
+  const Rotation measured_rotation =
+      -update * Rotation::Cast(sensor_from_start_rotation);
+
+  // The state is the rotation error r, with R_true = Exp(r) * R, so the
+  // innovation is the measured error itself and H = I.
+  const Vector3 innovation =
+      (measured_rotation *
+       -Rotation::Cast(current_state_.sensor_from_start_rotation))
+          .Log();
+  if (Length(innovation) > kMaxRotationInnovation) {
+    current_state_.sensor_from_start_rotation =
+        RotationType::Cast(measured_rotation);
+    state_covariance_ = rotation_measurement_covariance_;
+    rotation_bias_covariance_ = MatrixType::Zero();
+    PublishState();
+    return;
+  }
+
+  innovation_ = VectorType(innovation);
+  if (!UpdateState(MatrixType::Identity(), rotation_measurement_covariance_)) {
+    CARDBOARD_LOGE(
+        "SensorFusionEkf: innovation covariance is ill-conditioned, skipping "
+        "rotation update.");
+    return;
+  }
+  PublishState();
 }
 
-void SensorFusionEkf::ResetState() {
-  current_state_.sensor_from_start_rotation = Rotation::Identity();
-  current_state_.sensor_from_start_rotation_velocity = Vector3::Zero();
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::SaveCheckpoint(
+    Checkpoint* checkpoint) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  checkpoint->state = current_state_;
+  checkpoint->state_covariance = state_covariance_;
+  checkpoint->is_gyroscope_bias_in_state = is_gyroscope_bias_in_state_;
+  checkpoint->gyroscope_bias_estimate = gyroscope_bias_estimate_;
+  checkpoint->rotation_bias_covariance = rotation_bias_covariance_;
+  checkpoint->gyroscope_bias_covariance = gyroscope_bias_covariance_;
+  checkpoint->gyroscope_sensor_timestamp_ns =
+      current_gyroscope_sensor_timestamp_ns_;
+  checkpoint->previous_gyroscope_value = previous_gyroscope_value_;
+  checkpoint->accelerometer_sensor_timestamp_ns =
+      current_accelerometer_sensor_timestamp_ns_;
+  checkpoint->gyroscope_timestep_filter = gyroscope_timestep_filter_;
+  checkpoint->previous_accelerometer_norm = previous_accelerometer_norm_;
+  checkpoint->moving_average_accelerometer_norm_change =
+      moving_average_accelerometer_norm_change_;
+  checkpoint->is_aligned_with_gravity = is_aligned_with_gravity_;
+  checkpoint->execute_reset_with_next_accelerometer_sample =
+      execute_reset_with_next_accelerometer_sample_;
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::BeginReplay(const Checkpoint& checkpoint) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  is_replaying_ = true;
+  current_state_ = checkpoint.state;
+  state_covariance_ = checkpoint.state_covariance;
+  is_gyroscope_bias_in_state_ = checkpoint.is_gyroscope_bias_in_state;
+  // The estimator bias is left to its latest estimate.
+  if (is_gyroscope_bias_in_state_) {
+    gyroscope_bias_estimate_ = checkpoint.gyroscope_bias_estimate;
+  }
+  rotation_bias_covariance_ = checkpoint.rotation_bias_covariance;
+  gyroscope_bias_covariance_ = checkpoint.gyroscope_bias_covariance;
+  current_gyroscope_sensor_timestamp_ns_ =
+      checkpoint.gyroscope_sensor_timestamp_ns;
+  previous_gyroscope_value_ = checkpoint.previous_gyroscope_value;
+  current_accelerometer_sensor_timestamp_ns_ =
+      checkpoint.accelerometer_sensor_timestamp_ns;
+  gyroscope_timestep_filter_ = checkpoint.gyroscope_timestep_filter;
+  previous_accelerometer_norm_ = checkpoint.previous_accelerometer_norm;
+  moving_average_accelerometer_norm_change_ =
+      checkpoint.moving_average_accelerometer_norm_change;
+  is_aligned_with_gravity_ = checkpoint.is_aligned_with_gravity;
+  execute_reset_with_next_accelerometer_sample_ =
+      checkpoint.execute_reset_with_next_accelerometer_sample;
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::EndReplay() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  is_replaying_ = false;
+  PublishState();
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::SetRotationPredictionModel(
+    RotationPredictionModel model) {
+  rotation_prediction_model_ = model;
+}
+
+template <typename Scalar>
+RotationPredictionModel
+BasicSensorFusionEkf<Scalar>::GetRotationPredictionModel() const {
+  return rotation_prediction_model_;
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::SetGyroscopeBiasEstimation(
+    GyroscopeBiasEstimation estimation) {
+  if (gyroscope_bias_estimation_.exchange(estimation) != estimation) {
+    Reset();
+  }
+}
+
+template <typename Scalar>
+GyroscopeBiasEstimation
+BasicSensorFusionEkf<Scalar>::GetGyroscopeBiasEstimation() const {
+  return gyroscope_bias_estimation_;
+}
+
+template <typename Scalar>
+Vector3 BasicSensorFusionEkf<Scalar>::GetGyroscopeBias() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return gyroscope_bias_estimate_;
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::SetMeasurementJacobianCheckEnabled(
+    bool enabled) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  is_measurement_jacobian_check_enabled_ = enabled;
+  max_measurement_jacobian_error_ = 0.0;
+}
+
+template <typename Scalar>
+double BasicSensorFusionEkf<Scalar>::GetMaxMeasurementJacobianError() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return max_measurement_jacobian_error_;
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::ResetState() {
+  current_state_.sensor_from_start_rotation = RotationType::Identity();
+  current_state_.sensor_from_start_rotation_velocity = VectorType::Zero();
+  current_state_.sensor_from_start_rotation_acceleration = VectorType::Zero();
 
   current_gyroscope_sensor_timestamp_ns_ = 0;
+  previous_gyroscope_value_ = Vector3::Zero();
   current_accelerometer_sensor_timestamp_ns_ = 0;
 
-  state_covariance_ = Matrix3x3::Identity() * kInitialStateCovarianceValue;
-  process_covariance_ = Matrix3x3::Identity() * kInitialProcessCovarianceValue;
-  accelerometer_measurement_covariance_ =
-      Matrix3x3::Identity() * kMinAccelNoiseSigma * kMinAccelNoiseSigma;
-  innovation_covariance_ = Matrix3x3::Identity();
-
-  accelerometer_measurement_jacobian_ = Matrix3x3::Zero();
-  kalman_gain_ = Matrix3x3::Zero();
-  innovation_ = Vector3::Zero();
+  state_covariance_ =
+      SymmetricMatrixType::Identity() * kInitialStateCovarianceValue;
+  process_covariance_ =
+      SymmetricMatrixType::Identity() * kInitialProcessCovarianceValue;
+  accelerometer_measurement_covariance_ = SymmetricMatrixType::Identity() *
+                                          kMinAccelNoiseSigma *
+                                          kMinAccelNoiseSigma;
+  rotation_measurement_covariance_ = SymmetricMatrixType::Identity() *
+                                     kRotationMeasurementStdDev *
+                                     kRotationMeasurementStdDev;
+  innovation_covariance_ = SymmetricMatrixType::Identity();
+
+  accelerometer_measurement_jacobian_ = MatrixType::Zero();
+  kalman_gain_ = MatrixType::Zero();
+  innovation_ = VectorType::Zero();
   accelerometer_measurement_ = Vector3::Zero();
-  prediction_ = Vector3::Zero();
-  control_input_ = Vector3::Zero();
-  state_update_ = Vector3::Zero();
+  prediction_ = VectorType::Zero();
+  control_input_ = VectorType::Zero();
+  state_update_ = VectorType::Zero();
 
   moving_average_accelerometer_norm_change_ = 0.0;
 
-  is_timestep_filter_initialized_ = false;
-  is_gyroscope_filter_valid_ = false;
+  gyroscope_timestep_filter_.Reset();
   is_aligned_with_gravity_ = false;
 
-  // Reset biases.
-  gyroscope_bias_estimator_.Reset();
-  gyroscope_bias_estimate_ = {0, 0, 0};
+  // Reset biases. A replayed reset leaves them alone, as the bias estimator
+  // has already been reset and has seen the samples since. A bias estimated
+  // by the filter does not depend on the rotation, so it is kept with its
+  // covariance unless the filter has just started estimating it.
+  const bool was_gyroscope_bias_in_state = is_gyroscope_bias_in_state_;
+  is_gyroscope_bias_in_state_ =
+      gyroscope_bias_estimation_ == GyroscopeBiasEstimation::kFilterState;
+  rotation_bias_covariance_ = MatrixType::Zero();
+  if (is_gyroscope_bias_in_state_) {
+    if (!was_gyroscope_bias_in_state) {
+      gyroscope_bias_estimate_ = {0, 0, 0};
+      gyroscope_bias_covariance_ = SymmetricMatrixType::Identity() *
+                                   kInitialGyroscopeBiasStdDev *
+                                   kInitialGyroscopeBiasStdDev;
+    }
+  } else if (!is_replaying_) {
+    gyroscope_bias_estimator_.Reset();
+    gyroscope_bias_estimate_ = {0, 0, 0};
+  }
+
+  PublishState();
+}
+
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::PublishState() {
+  if (is_replaying_) {
+    return;
+  }
+  published_state_.Store(current_state_);
 }
 
 // Here I am doing something wrong relative to time stamps. The state timestamps
 // always correspond to the gyrostamps because it would require additional
 // extrapolation if I wanted to do otherwise.
-RotationState SensorFusionEkf::GetLatestRotationState() const {
-  std::unique_lock<std::mutex> lock(mutex_);
-  return current_state_;
+template <typename Scalar>
+typename BasicSensorFusionEkf<Scalar>::RotationStateType
+BasicSensorFusionEkf<Scalar>::GetLatestRotationState() const {
+  return published_state_.Load();
 }
 
-Rotation SensorFusionEkf::PredictRotation(int64_t requested_timestamp) const {
-  std::unique_lock<std::mutex> lock(mutex_);
+template <typename Scalar>
+typename BasicSensorFusionEkf<Scalar>::RotationType
+BasicSensorFusionEkf<Scalar>::PredictRotation(
+    int64_t requested_timestamp) const {
+  const RotationStateType state = published_state_.Load();
   // If the required timestamp is equal to zero, return the current pose.
   if (requested_timestamp == 0) {
-    return current_state_.sensor_from_start_rotation;
+    return state.sensor_from_start_rotation;
   }
 
   // Subtracting unsigned numbers is bad when the result is negative.
-  const double timestep_s = ComputeTimeDifferenceInSeconds(
-      requested_timestamp, current_state_.timestamp);
-
-  const Rotation update = GetRotationFromGyroscope(
-      current_state_.sensor_from_start_rotation_velocity, timestep_s);
-  return update * current_state_.sensor_from_start_rotation;
+  const double timestep_s =
+      ComputeTimeDifferenceInSeconds(requested_timestamp, state.timestamp);
+
+  Vector3 velocity(state.sensor_from_start_rotation_velocity);
+  if (rotation_prediction_model_ ==
+      RotationPredictionModel::kConstantAcceleration) {
+    velocity += Vector3(state.sensor_from_start_rotation_acceleration) *
+                GetAngularAccelerationPredictionTime(timestep_s);
+  }
+  const Rotation update = GetRotationFromGyroscope(velocity, timestep_s);
+  return RotationType::Cast(update) * state.sensor_from_start_rotation;
 }
 
-void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample) {
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::ProcessGyroscopeSample(
+    const GyroscopeData& sample) {
   std::unique_lock<std::mutex> lock(mutex_);
 
   // Don't accept gyroscope sample when waiting for a reset.
@@ -194,84 +388,181 @@ void SensorFusionEkf::ProcessGyroscopeSample(const GyroscopeData& sample) {
             std::chrono::nanoseconds(sample.sensor_timestamp_ns -
                                      current_gyroscope_sensor_timestamp_ns_))
             .count();
-    if (current_timestep_s > kMaximumGyroscopeSampleDelay_s) {
-      if (is_gyroscope_filter_valid_) {
-        // Replaces the delta timestamp by the filtered estimates of the delta
-        // time.
-        current_timestep_s = filtered_gyroscope_timestep_s_;
-      } else {
-        current_timestep_s = kDefaultGyroscopeTimestep_s;
-      }
+    if (GyroscopeTimestepFilter::IsGap(current_timestep_s)) {
+      // Replaces the delta timestamp by the filtered estimates of the delta
+      // time.
+      current_timestep_s = gyroscope_timestep_filter_.GetFilteredTimestep();
+      // The velocity change across a gap in the samples says nothing about
+      // the current acceleration.
+      current_state_.sensor_from_start_rotation_acceleration =
+          VectorType::Zero();
     } else {
-      FilterGyroscopeTimestep(current_timestep_s);
+      gyroscope_timestep_filter_.AddTimestep(current_timestep_s);
+      FilterAngularAcceleration(sample.data, current_timestep_s);
     }
 
     // { Process gyroscope bias estimation
-    gyroscope_bias_estimator_.ProcessGyroscope(sample.data,
-                                               sample.sensor_timestamp_ns);
+    // A replayed sample has already been seen by the estimator.
+    if (!is_replaying_ && !is_gyroscope_bias_in_state_) {
+      gyroscope_bias_estimator_.ProcessGyroscope(sample.data,
+                                                 sample.sensor_timestamp_ns);
 
-    if (gyroscope_bias_estimator_.IsCurrentEstimateValid()) {
-      // As soon as the device is considered to be static, the bias estimator
-      // should have a precise estimate of the gyroscope bias.
-      gyroscope_bias_estimate_ = gyroscope_bias_estimator_.GetGyroscopeBias();
+      if (gyroscope_bias_estimator_.IsCurrentEstimateValid()) {
+        // As soon as the device is considered to be static, the bias
+        // estimator should have a precise estimate of the gyroscope bias.
+        gyroscope_bias_estimate_ =
+            gyroscope_bias_estimator_.GetGyroscopeBias();
+      }
     }
     // }
 
     // Only integrate after receiving a accelerometer sample.
     if (is_aligned_with_gravity_) {
-      const Rotation rotation_from_gyroscope =
-          GetRotationFromGyroscope(
+      const RotationType rotation_from_gyroscope =
+          RotationType::Cast(GetRotationFromGyroscope(
               {sample.data[0] - gyroscope_bias_estimate_[0],
                sample.data[1] - gyroscope_bias_estimate_[1],
                sample.data[2] - gyroscope_bias_estimate_[2]},
-              current_timestep_s);
+              current_timestep_s));
       current_state_.sensor_from_start_rotation =
           rotation_from_gyroscope * current_state_.sensor_from_start_rotation;
-      UpdateStateCovariance(RotationMatrixNH(rotation_from_gyroscope));
-      state_covariance_ =
-          state_covariance_ +
-          ((current_timestep_s * current_timestep_s) * process_covariance_);
+      if (is_gyroscope_bias_in_state_) {
+        PredictGyroscopeBiasCovariance(
+            RotationMatrixNH(rotation_from_gyroscope), current_timestep_s);
+      } else {
+        // P = F * P * F' + dt^2 * Q
+        state_covariance_ = PredictCovariance(
+            RotationMatrixNH(rotation_from_gyroscope), state_covariance_,
+            Scalar(current_timestep_s * current_timestep_s),
+            process_covariance_);
+      }
     }
   }
 
   // Saves gyroscope event for future prediction.
   current_state_.timestamp = sample.system_timestamp;
   current_gyroscope_sensor_timestamp_ns_ = sample.sensor_timestamp_ns;
-  current_state_.sensor_from_start_rotation_velocity.Set(
-      sample.data[0] - gyroscope_bias_estimate_[0],
-      sample.data[1] - gyroscope_bias_estimate_[1],
-      sample.data[2] - gyroscope_bias_estimate_[2]);
+  previous_gyroscope_value_ = sample.data;
+  current_state_.sensor_from_start_rotation_velocity =
+      VectorType(Vector3(sample.data[0] - gyroscope_bias_estimate_[0],
+                         sample.data[1] - gyroscope_bias_estimate_[1],
+                         sample.data[2] - gyroscope_bias_estimate_[2]));
+  PublishState();
 }
 
-Vector3 SensorFusionEkf::ComputeInnovation(const Rotation& rotation_in) {
+template <typename Scalar>
+Vector3 BasicSensorFusionEkf<Scalar>::ComputeInnovation(
+    const Rotation& rotation_in) const {
   const Vector3 predicted_down_direction = rotation_in * kCanonicalZDirection;
 
   const Rotation rotation = Rotation::RotateInto(predicted_down_direction,
                                                  accelerometer_measurement_);
-  Vector3 axis;
-  double angle;
-  rotation.GetAxisAndAngle(&axis, &angle);
-  return axis * angle;
+  return rotation.Log();
+}
+
+// The innovation is nu = theta * c / s, where p is the predicted down
+// direction, a the normalized accelerometer direction, c = p x a, s = |c|,
+// d = p.a and theta = atan2(s, d). Perturbing the state by a small rotation
+// delta gives dp = delta x p, hence dc = [a]x [p]x delta and dd = c' delta.
+// Writing g = theta / s, and using s^2 + d^2 = 1:
+//   dnu/ddelta = g * dc + c * ((dg/ds / s) * c' * dc - c')
+// The Jacobian is the opposite of this because the numerical formulation
+// differentiated innovation_ - nu(delta).
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::ComputeMeasurementJacobian() {
+  const VectorType predicted_down_direction =
+      current_state_.sensor_from_start_rotation *
+      VectorType(kCanonicalZDirection);
+  VectorType measured_down_direction(accelerometer_measurement_);
+  const bool is_measurement_valid = Normalize(&measured_down_direction);
+  const VectorType c = Cross(predicted_down_direction, measured_down_direction);
+  const Scalar s = Length(c);
+  const Scalar d = Dot(predicted_down_direction, measured_down_direction);
+
+  if (!is_measurement_valid || (s < kSmallInnovationSine && d < 0.0)) {
+    // The innovation axis is undefined for a null measurement or opposite
+    // directions.
+    accelerometer_measurement_jacobian_ =
+        MatrixType(ComputeNumericalMeasurementJacobian());
+    return;
+  }
+
+  Scalar g;
+  Scalar dg_ds_over_s;
+  if (s < kSmallInnovationSine) {
+    // Taylor expansions of theta / sin(theta) and its derivative.
+    g = Scalar(1.0) + s * s / Scalar(6.0);
+    dg_ds_over_s = Scalar(-2.0 / 3.0);
+  } else {
+    const Scalar theta = std::atan2(s, d);
+    g = theta / s;
+    dg_ds_over_s = (d * s - theta) / (s * s * s);
+  }
+
+  const MatrixType dc = SkewSymmetric(measured_down_direction) *
+                        SkewSymmetric(predicted_down_direction);
+  // Row vector c' * dc.
+  const VectorType c_dc = Transpose(dc) * c;
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      accelerometer_measurement_jacobian_(row, col) =
+          -(g * dc(row, col) +
+            c[row] * (dg_ds_over_s * c_dc[col] - c[col]));
+    }
+  }
+
+  if (is_measurement_jacobian_check_enabled_) {
+    const Matrix3x3 numerical_jacobian = ComputeNumericalMeasurementJacobian();
+    double error = 0.0;
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col) {
+        const double difference =
+            numerical_jacobian(row, col) -
+            accelerometer_measurement_jacobian_(row, col);
+        error = std::max(error, std::abs(difference));
+      }
+    }
+    if (error > kMeasurementJacobianCheckTolerance) {
+      CARDBOARD_LOGE(
+          "SensorFusionEkf: analytic measurement Jacobian differs from the "
+          "numerical one by %f.",
+          error);
+    }
+    max_measurement_jacobian_error_ =
+        std::max(max_measurement_jacobian_error_, error);
+  }
 }
 
-void SensorFusionEkf::ComputeMeasurementJacobian() {
+template <typename Scalar>
+Matrix3x3 BasicSensorFusionEkf<Scalar>::ComputeNumericalMeasurementJacobian()
+    const {
+  // The product with the perturbation renormalizes the rotation, so it is
+  // normalized in double first. Otherwise the rounding of a float state, about
+  // 1e-7, would be differentiated with kFiniteDifferencingEpsilon.
+  const Rotation rotation = Rotation::FromQuaternion(
+      Rotation::Cast(current_state_.sensor_from_start_rotation)
+          .GetQuaternion());
+  const Vector3 innovation = ComputeInnovation(rotation);
+  Matrix3x3 jacobian;
   for (int dof = 0; dof < 3; dof++) {
     Vector3 delta = Vector3::Zero();
     delta[dof] = kFiniteDifferencingEpsilon;
 
-    const Rotation epsilon_rotation = RotationFromVector(delta);
-    const Vector3 delta_rotation = ComputeInnovation(
-        epsilon_rotation * current_state_.sensor_from_start_rotation);
+    const Rotation epsilon_rotation = Rotation::Exp(delta);
+    const Vector3 delta_rotation =
+        ComputeInnovation(epsilon_rotation * rotation);
 
     const Vector3 col =
-        (innovation_ - delta_rotation) / kFiniteDifferencingEpsilon;
-    accelerometer_measurement_jacobian_(0, dof) = col[0];
-    accelerometer_measurement_jacobian_(1, dof) = col[1];
-    accelerometer_measurement_jacobian_(2, dof) = col[2];
+        (innovation - delta_rotation) / kFiniteDifferencingEpsilon;
+    jacobian(0, dof) = col[0];
+    jacobian(1, dof) = col[1];
+    jacobian(2, dof) = col[2];
   }
+  return jacobian;
 }
 
-void SensorFusionEkf::ProcessAccelerometerSample(
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::ProcessAccelerometerSample(
     const AccelerometerData& sample) {
   std::unique_lock<std::mutex> lock(mutex_);
 
@@ -291,78 +582,154 @@ void SensorFusionEkf::ProcessAccelerometerSample(
   current_accelerometer_sensor_timestamp_ns_ = sample.sensor_timestamp_ns;
 
   // Process gyroscope bias estimation.
-  gyroscope_bias_estimator_.ProcessAccelerometer(sample.data,
-                                                 sample.sensor_timestamp_ns);
+  if (!is_replaying_ && !is_gyroscope_bias_in_state_) {
+    gyroscope_bias_estimator_.ProcessAccelerometer(sample.data,
+                                                   sample.sensor_timestamp_ns);
+  }
 
   if (!is_aligned_with_gravity_) {
     // This is the first accelerometer measurement so it initializes the
     // orientation estimate.
-    current_state_.sensor_from_start_rotation =
-        Rotation::RotateInto(kCanonicalZDirection, accelerometer_measurement_);
+    current_state_.sensor_from_start_rotation = RotationType::Cast(
+        Rotation::RotateInto(kCanonicalZDirection, accelerometer_measurement_));
     is_aligned_with_gravity_ = true;
 
     previous_accelerometer_norm_ = Length(accelerometer_measurement_);
+    PublishState();
     return;
   }
 
   UpdateMeasurementCovariance();
 
-  innovation_ = ComputeInnovation(current_state_.sensor_from_start_rotation);
+  innovation_ = VectorType(ComputeInnovation(
+      Rotation::Cast(current_state_.sensor_from_start_rotation)));
   ComputeMeasurementJacobian();
 
+  if (!UpdateState(accelerometer_measurement_jacobian_,
+                   accelerometer_measurement_covariance_)) {
+    CARDBOARD_LOGE(
+        "SensorFusionEkf: innovation covariance is ill-conditioned, skipping "
+        "accelerometer update.");
+    return;
+  }
+  PublishState();
+}
+
+template <typename Scalar>
+bool BasicSensorFusionEkf<Scalar>::UpdateState(
+    const MatrixType& measurement_jacobian,
+    const SymmetricMatrixType& measurement_covariance) {
   // S = H * P * H' + R
-  innovation_covariance_ = accelerometer_measurement_jacobian_ *
-                               state_covariance_ *
-                               Transpose(accelerometer_measurement_jacobian_) +
-                           accelerometer_measurement_covariance_;
+  innovation_covariance_ =
+      SandwichProduct(measurement_jacobian, state_covariance_) +
+      measurement_covariance;
 
   // K = P * H' * S^-1
-  kalman_gain_ = state_covariance_ *
-                 Transpose(accelerometer_measurement_jacobian_) *
-                 Inverse(innovation_covariance_);
+  if (!SolveSymmetricPositiveDefinite(
+          innovation_covariance_,
+          ProductWithTranspose(state_covariance_, measurement_jacobian),
+          Scalar(kMinInnovationCovariancePivotRatio), &kalman_gain_)) {
+    return false;
+  }
 
   // x_update = K*nu
   state_update_ = kalman_gain_ * innovation_;
 
-  // P = (I - K * H) * P;
-  state_covariance_ = (Matrix3x3::Identity() -
-                       kalman_gain_ * accelerometer_measurement_jacobian_) *
-                      state_covariance_;
+  if (is_gyroscope_bias_in_state_) {
+    // The measurement does not depend on the bias b, so H = [H_r 0] and the
+    // bias gain is K_b = P_br * H_r' * S^-1. The covariance blocks are updated
+    // as (I - K * H) * P, which keeps P_bb symmetric for the optimal gain.
+    MatrixType bias_gain;
+    if (SolveSymmetricPositiveDefinite(
+            innovation_covariance_,
+            Transpose(rotation_bias_covariance_) *
+                Transpose(measurement_jacobian),
+            Scalar(kMinInnovationCovariancePivotRatio), &bias_gain)) {
+      const MatrixType measured_rotation_bias_covariance =
+          measurement_jacobian * rotation_bias_covariance_;
+      gyroscope_bias_estimate_ += Vector3(bias_gain * innovation_);
+      gyroscope_bias_covariance_ = SymmetricMatrixType::FromMatrix(
+          gyroscope_bias_covariance_.ToMatrix() -
+          bias_gain * measured_rotation_bias_covariance);
+      rotation_bias_covariance_ =
+          rotation_bias_covariance_ -
+          kalman_gain_ * measured_rotation_bias_covariance;
+    }
+  }
+
+  // P = (I - K * H) * P * (I - K * H)' + K * R * K'
+  state_covariance_ =
+      JosephUpdateCovariance(kalman_gain_, measurement_jacobian,
+                             state_covariance_, measurement_covariance);
 
   // Updates rotation and associate covariance matrix.
-  const Rotation rotation_from_state_update = RotationFromVector(state_update_);
+  const RotationType rotation_from_state_update =
+      RotationType::Cast(Rotation::Exp(Vector3(state_update_)));
 
   current_state_.sensor_from_start_rotation =
       rotation_from_state_update * current_state_.sensor_from_start_rotation;
   UpdateStateCovariance(RotationMatrixNH(rotation_from_state_update));
+  return true;
 }
 
-void SensorFusionEkf::UpdateStateCovariance(const Matrix3x3& motion_update) {
-  state_covariance_ =
-      motion_update * state_covariance_ * Transpose(motion_update);
-}
-
-void SensorFusionEkf::FilterGyroscopeTimestep(double gyroscope_timestep_s) {
-  if (!is_timestep_filter_initialized_) {
-    // Initializes the filter.
-    filtered_gyroscope_timestep_s_ = gyroscope_timestep_s;
-    num_gyroscope_timestep_samples_ = 1;
-    is_timestep_filter_initialized_ = true;
-    return;
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::UpdateStateCovariance(
+    const MatrixType& motion_update) {
+  state_covariance_ = SandwichProduct(motion_update, state_covariance_);
+  if (is_gyroscope_bias_in_state_) {
+    rotation_bias_covariance_ = motion_update * rotation_bias_covariance_;
   }
+}
 
-  // Computes the IIR filter response.
-  filtered_gyroscope_timestep_s_ =
-      kTimestepFilterCoeff * filtered_gyroscope_timestep_s_ +
-      (1 - kTimestepFilterCoeff) * gyroscope_timestep_s;
-  ++num_gyroscope_timestep_samples_;
+// The rotation is integrated as R' = Exp(-(w - b) * dt) * R, and its error r
+// is defined by R_true = Exp(r) * R. A bias error db turns the integrated
+// rotation into Exp(db * dt) * Exp(-(w - b) * dt) to first order, hence, with
+// F the rotation matrix of the integrated sample:
+//   r' = F * r + dt * db
+//   P_rr' = F * P_rr * F' + dt * (F * P_rb + P_br * F') + dt^2 * (P_bb + Q)
+//   P_rb' = F * P_rb + dt * P_bb
+//   P_bb' = P_bb + dt * Q_b
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::PredictGyroscopeBiasCovariance(
+    const MatrixType& motion_update, double timestep_s) {
+  const Scalar dt = Scalar(timestep_s);
+  const MatrixType moved_rotation_bias_covariance =
+      motion_update * rotation_bias_covariance_;
+  state_covariance_ =
+      PredictCovariance(motion_update, state_covariance_, dt * dt,
+                        process_covariance_) +
+      SymmetricMatrixType::FromMatrix(
+          (moved_rotation_bias_covariance +
+           Transpose(moved_rotation_bias_covariance)) *
+          dt) +
+      gyroscope_bias_covariance_ * (dt * dt);
+  rotation_bias_covariance_ = moved_rotation_bias_covariance +
+                              gyroscope_bias_covariance_.ToMatrix() * dt;
+  gyroscope_bias_covariance_ =
+      gyroscope_bias_covariance_ +
+      SymmetricMatrixType::Identity() *
+          Scalar(kGyroscopeBiasRandomWalk * kGyroscopeBiasRandomWalk *
+                 timestep_s);
+}
 
-  if (num_gyroscope_timestep_samples_ > kTimestepFilterMinSamples) {
-    is_gyroscope_filter_valid_ = true;
-  }
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::FilterAngularAcceleration(
+    const Vector3& gyroscope_value, double timestep_s) {
+  // The raw samples are differenced: the gyroscope bias cancels out of the
+  // difference, whereas its estimate, which the accelerometer updates move
+  // between two gyroscope samples when it is a state of the filter, would
+  // not.
+  const Vector3 velocity_change = gyroscope_value - previous_gyroscope_value_;
+  const double coefficient =
+      timestep_s / (kAngularAccelerationFilterTime_s + timestep_s);
+  Vector3 acceleration(current_state_.sensor_from_start_rotation_acceleration);
+  acceleration += (velocity_change / timestep_s - acceleration) * coefficient;
+  current_state_.sensor_from_start_rotation_acceleration =
+      VectorType(acceleration);
 }
 
-void SensorFusionEkf::UpdateMeasurementCovariance() {
+template <typename Scalar>
+void BasicSensorFusionEkf<Scalar>::UpdateMeasurementCovariance() {
   const double current_accelerometer_norm = Length(accelerometer_measurement_);
   // Norm change between current and previous accel readings.
   const double current_accelerometer_norm_change =
@@ -384,9 +751,12 @@ void SensorFusionEkf::UpdateMeasurementCovariance() {
           norm_change_ratio * (kMaxAccelNoiseSigma - kMinAccelNoiseSigma));
 
   // Updates the accel covariance matrix with the new sigma value.
-  accelerometer_measurement_covariance_ = Matrix3x3::Identity() *
+  accelerometer_measurement_covariance_ = SymmetricMatrixType::Identity() *
                                           accelerometer_noise_sigma *
                                           accelerometer_noise_sigma;
 }
 
+template class BasicSensorFusionEkf<double>;
+template class BasicSensorFusionEkf<float>;
+
 }  // namespace cardboard
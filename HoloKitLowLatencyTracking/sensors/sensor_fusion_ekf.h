@@ -24,23 +24,85 @@
 #include "sensors/accelerometer_data.h"
 #include "sensors/gyroscope_bias_estimator.h"
 #include "sensors/gyroscope_data.h"
+#include "sensors/gyroscope_integration.h"
 #include "sensors/rotation_state.h"
 #include "util/matrix_3x3.h"
 #include "util/rotation.h"
+#include "util/seqlock.h"
+#include "util/symmetric_matrix_3x3.h"
 #include "util/vector.h"
 
 namespace cardboard {
 
+// Motion models that PredictRotation() can extrapolate the rotation with.
+enum class RotationPredictionModel {
+  // The latest bias corrected angular velocity is held over the whole
+  // prediction horizon.
+  kConstantVelocity,
+  // The angular acceleration estimated from the gyroscope stream is added to
+  // the angular velocity. It is assumed to decay over the horizon, so that it
+  // corrects the end and start of head turns without making long predictions
+  // diverge.
+  kConstantAcceleration,
+};
+
+// Sources of the gyroscope bias subtracted from the gyroscope samples.
+enum class GyroscopeBiasEstimation {
+  // GyroscopeBiasEstimator, which only updates the bias while the device is
+  // still.
+  kStaticDevice,
+  // The bias is a state of the filter next to the rotation error, which makes
+  // it an error-state Kalman filter. The accelerometer updates correct it
+  // while moving too, on the axes that are not aligned with gravity, and the
+  // rotation measurements on all axes.
+  kFilterState,
+};
+
 // Sensor fusion class that implements an Extended Kalman Filter (EKF) to
 // estimate a 3D rotation from a gyroscope and an accelerometer.
-// This system only has one state, the rotation. It does not estimate any
-// velocity or acceleration.
+// This system only has one state, the rotation, unless the gyroscope bias is
+// estimated by the filter, see GyroscopeBiasEstimation. It does not estimate
+// any velocity or acceleration.
 //
 // To learn more about Kalman filtering one can read this article which is a
 // good introduction: https://en.wikipedia.org/wiki/Kalman_filter
-class SensorFusionEkf {
+//
+// The filter state, covariances and gain are stored as Scalar. Use the
+// SensorFusionEkf (double) and FloatSensorFusionEkf (float) typedefs. Whatever
+// the Scalar type, the sensor samples, the timestamp deltas, the integration
+// of each gyroscope sample and the innovation are computed in double, since
+// they are small differences of large values or small angles.
+template <typename Scalar>
+class BasicSensorFusionEkf {
  public:
-  SensorFusionEkf();
+  typedef BasicRotation<Scalar> RotationType;
+  typedef BasicRotationState<Scalar> RotationStateType;
+  typedef Vector<3, Scalar> VectorType;
+  typedef BasicMatrix3x3<Scalar> MatrixType;
+  typedef BasicSymmetricMatrix3x3<Scalar> SymmetricMatrixType;
+
+  // Filter state saved by SaveCheckpoint() and restored by BeginReplay(). The
+  // gyroscope bias estimator is not part of it: it has already seen the
+  // samples that are replayed, so its latest estimate is used for them. A
+  // bias estimated by the filter is part of it.
+  struct Checkpoint {
+    RotationStateType state;
+    SymmetricMatrixType state_covariance;
+    bool is_gyroscope_bias_in_state;
+    Vector3 gyroscope_bias_estimate;
+    MatrixType rotation_bias_covariance;
+    SymmetricMatrixType gyroscope_bias_covariance;
+    uint64_t gyroscope_sensor_timestamp_ns;
+    Vector3 previous_gyroscope_value;
+    uint64_t accelerometer_sensor_timestamp_ns;
+    GyroscopeTimestepFilter gyroscope_timestep_filter;
+    double previous_accelerometer_norm;
+    double moving_average_accelerometer_norm_change;
+    bool is_aligned_with_gravity;
+    bool execute_reset_with_next_accelerometer_sample;
+  };
+
+  BasicSensorFusionEkf();
 
   // Resets the state of the sensor fusion. It sets the velocity for
   // prediction to zero. The reset will happen with the next
@@ -50,7 +112,14 @@ class SensorFusionEkf {
 
   // Gets the RotationState representing the latest rotation and angular
   // velocity at a particular timestamp as estimated by SensorFusion.
-  RotationState GetLatestRotationState() const;
+  //
+  // This reads the latest published snapshot and never waits for a sensor
+  // update in progress, so it is safe to call from the render thread.
+  RotationStateType GetLatestRotationState() const;
+
+  // Returns true once the rotation has been aligned with gravity by the first
+  // accelerometer sample after a reset.
+  bool IsAlignedWithGravity() const { return is_aligned_with_gravity_; }
 
   // Gets a predicted rotation for a given time in the future (e.g. rendering
   // time) based on a linear prediction model (this EKF implementation). It uses
@@ -61,7 +130,29 @@ class SensorFusionEkf {
   // @return If the requested timestamp is equal to zero, it returns the current
   //         rotation. Otherwise, it returns the rotation from Start to Sensor
   //         Space.
-  Rotation PredictRotation(int64_t requested_timestamp) const;
+  //
+  // Like GetLatestRotationState(), this never waits for a sensor update.
+  RotationType PredictRotation(int64_t requested_timestamp) const;
+
+  // Selects the motion model used by PredictRotation(). It defaults to
+  // RotationPredictionModel::kConstantVelocity. This can be called from any
+  // thread.
+  //
+  // @param model the prediction model.
+  void SetRotationPredictionModel(RotationPredictionModel model);
+  RotationPredictionModel GetRotationPredictionModel() const;
+
+  // Selects how the gyroscope bias is estimated. It defaults to
+  // GyroscopeBiasEstimation::kStaticDevice. Selecting another estimation
+  // resets the filter like Reset(). This can be called from any thread.
+  //
+  // @param estimation the bias estimation.
+  void SetGyroscopeBiasEstimation(GyroscopeBiasEstimation estimation);
+  GyroscopeBiasEstimation GetGyroscopeBiasEstimation() const;
+
+  // Returns the gyroscope bias currently subtracted from the samples, in
+  // rad/s.
+  Vector3 GetGyroscopeBias() const;
 
   // Processes one gyroscope sample event. This updates the rotation of the
   // system and the prediction model. The gyroscope data is assumed to be in
@@ -86,25 +177,103 @@ class SensorFusionEkf {
   //
   // @param rotation The Rotation that maps from the Sensor Space
   //                 frame to Start Space.
-  void RotateSensorSpaceToStartSpaceTransformation(const Rotation& rotation);
+  void RotateSensorSpaceToStartSpaceTransformation(
+      const RotationType& rotation);
+
+  // Corrects the rotation estimate with @p sensor_from_start_rotation,
+  // measured by an external tracker at @p timestamp. The measurement is
+  // integrated back to the current gyroscope sample with the current angular
+  // velocity and applied as a Kalman update of the three rotation axes, so it
+  // also observes the heading and, when it is a state, the bias around
+  // gravity. A measurement far from the estimate, e.g. the first one or after
+  // the tracker relocalized, replaces it instead, and resets the rotation
+  // covariance to that of the measurement. Ignored until the filter is
+  // aligned with gravity.
+  //
+  // @param sensor_from_start_rotation measured rotation from Start to Sensor
+  //        Space.
+  // @param timestamp system time of the measurement, normally between the
+  //        current gyroscope sample and the next one.
+  void ProcessRotationMeasurement(
+      const RotationType& sensor_from_start_rotation, int64_t timestamp);
+
+  // Saves the filter state to rewind to it with BeginReplay().
+  //
+  // @param checkpoint receives the state.
+  void SaveCheckpoint(Checkpoint* checkpoint) const;
+
+  // Rewinds the filter to @p checkpoint to replay the samples processed since
+  // it was saved, so that a delayed measurement can be applied at its time.
+  // Until EndReplay(), the state is not published to GetLatestRotationState()
+  // and PredictRotation(), and the replayed samples are not fed to the
+  // gyroscope bias estimator. The caller must not process live samples
+  // during the replay.
+  //
+  // @param checkpoint state to rewind to.
+  void BeginReplay(const Checkpoint& checkpoint);
+
+  // Ends a replay started with BeginReplay() and publishes the replayed state.
+  void EndReplay();
+
+  // Enables a debug mode in which every analytic accelerometer measurement
+  // Jacobian is compared against one obtained by finite differencing. This
+  // triples the cost of an accelerometer update, so it is meant for tests and
+  // offline trace replay only.
+  //
+  // @param enabled whether the cross-check runs.
+  void SetMeasurementJacobianCheckEnabled(bool enabled);
+
+  // Returns the largest absolute element-wise difference between the analytic
+  // and numerical measurement Jacobians seen since the cross-check was enabled.
+  double GetMaxMeasurementJacobianError() const;
+
+  // Difference between the analytic and numerical measurement Jacobians above
+  // which the cross-check logs an error. The numerical Jacobian goes through
+  // acos() near 1, which limits it to about 1e-4 of accuracy.
+  static constexpr double kMeasurementJacobianCheckTolerance = 1e-3;
 
  private:
-  // Estimates the average timestep between gyroscope event.
-  void FilterGyroscopeTimestep(double gyroscope_timestep);
+  // Updates the smoothed angular acceleration of current_state_ from the
+  // change of angular velocity between the previous gyroscope sample and
+  // @p gyroscope_value, @p timestep_s apart. Lock should be acquired outside
+  // of it.
+  void FilterAngularAcceleration(const Vector3& gyroscope_value,
+                                 double timestep_s);
 
   // Updates the state covariance with an incremental motion. It changes the
   // space of the quadric.
-  void UpdateStateCovariance(const Matrix3x3& motion_update);
+  void UpdateStateCovariance(const MatrixType& motion_update);
+
+  // Applies the Kalman update of innovation_, whose Jacobian with respect to
+  // the rotation error is @p measurement_jacobian, to the rotation, the bias
+  // when it is a state, and their covariances.
+  //
+  // @return false if the innovation covariance is ill-conditioned, in which
+  //         case the state is left unchanged.
+  bool UpdateState(const MatrixType& measurement_jacobian,
+                   const SymmetricMatrixType& measurement_covariance);
+
+  // Predicts the rotation, rotation-bias and bias covariances over a
+  // gyroscope sample when the bias is a state. @p motion_update is the
+  // rotation matrix of the integrated sample.
+  void PredictGyroscopeBiasCovariance(const MatrixType& motion_update,
+                                      double timestep_s);
 
   // Computes the innovation vector of the Kalman based on the input rotation.
   // It uses the latest measurement vector (i.e. accelerometer data), which must
   // be set prior to calling this function.
-  Vector3 ComputeInnovation(const Rotation& rotation_in);
+  Vector3 ComputeInnovation(const Rotation& rotation_in) const;
 
-  // This computes the measurement_jacobian_ via numerical differentiation based
-  // on the current value of sensor_from_start_rotation_.
+  // This computes the measurement_jacobian_ in closed form based on the
+  // current value of sensor_from_start_rotation_ and
+  // accelerometer_measurement_.
   void ComputeMeasurementJacobian();
 
+  // Computes the measurement Jacobian via numerical differentiation of
+  // ComputeInnovation(), in double. Used when the closed form is singular and
+  // by the cross-check mode.
+  Matrix3x3 ComputeNumericalMeasurementJacobian() const;
+
   // Updates the accelerometer covariance matrix.
   //
   // This looks at the norm of recent accelerometer readings. If it has changed
@@ -116,52 +285,60 @@ class SensorFusionEkf {
   // outside of it. This function is called in ProcessAccelerometerSample.
   void ResetState();
 
+  // Publishes current_state_ for GetLatestRotationState() and
+  // PredictRotation(). Lock should be acquired outside of it.
+  void PublishState();
+
   // Current transformation from Sensor Space to Start Space.
   // x_sensor = sensor_from_start_rotation_ * x_start;
-  RotationState current_state_;
+  // Only accessed with mutex_ held.
+  RotationStateType current_state_;
+
+  // Snapshot of current_state_ read by the render thread without locking.
+  SeqLock<RotationStateType> published_state_;
 
-  // Filtering of the gyroscope timestep started?
-  bool is_timestep_filter_initialized_;
-  // Filtered gyroscope timestep valid?
-  bool is_gyroscope_filter_valid_;
   // Sensor fusion currently aligned with gravity? After initialization
   // it will requires a couple of accelerometer data for the system to get
   // aligned.
   std::atomic<bool> is_aligned_with_gravity_;
 
   // Covariance of Kalman filter state (P in common formulation).
-  Matrix3x3 state_covariance_;
+  SymmetricMatrixType state_covariance_;
   // Covariance of the process noise (Q in common formulation).
-  Matrix3x3 process_covariance_;
+  SymmetricMatrixType process_covariance_;
   // Covariance of the accelerometer measurement (R in common formulation).
-  Matrix3x3 accelerometer_measurement_covariance_;
+  SymmetricMatrixType accelerometer_measurement_covariance_;
+  // Covariance of the rotation measurement.
+  SymmetricMatrixType rotation_measurement_covariance_;
   // Covariance of innovation (S in common formulation).
-  Matrix3x3 innovation_covariance_;
+  SymmetricMatrixType innovation_covariance_;
   // Jacobian of the measurements (H in common formulation).
-  Matrix3x3 accelerometer_measurement_jacobian_;
+  MatrixType accelerometer_measurement_jacobian_;
   // Gain of the Kalman filter (K in common formulation).
-  Matrix3x3 kalman_gain_;
+  MatrixType kalman_gain_;
   // Parameter update a.k.a. innovation vector. (\nu in common formulation).
-  Vector3 innovation_;
-  // Measurement vector (z in common formulation).
+  VectorType innovation_;
+  // Measurement vector (z in common formulation), kept in double like the
+  // sensor sample it comes from.
   Vector3 accelerometer_measurement_;
   // Current prediction vector (g in common formulation).
-  Vector3 prediction_;
+  VectorType prediction_;
   // Control input, currently this is only the gyroscope data (\mu in common
   // formulation).
-  Vector3 control_input_;
+  VectorType control_input_;
   // Update of the state vector. (x in common formulation).
-  Vector3 state_update_;
+  VectorType state_update_;
 
   // Sensor time of the last gyroscope processed event.
   uint64_t current_gyroscope_sensor_timestamp_ns_;
+  // Angular velocity of the last gyroscope processed event, before the bias
+  // correction.
+  Vector3 previous_gyroscope_value_;
   // Sensor time of the last accelerometer processed event.
   uint64_t current_accelerometer_sensor_timestamp_ns_;
 
-  // Estimates of the timestep between gyroscope event in seconds.
-  double filtered_gyroscope_timestep_s_;
-  // Number of timestep samples processed so far by the filter.
-  uint32_t num_gyroscope_timestep_samples_;
+  // Estimates the timestep between gyroscope events.
+  GyroscopeTimestepFilter gyroscope_timestep_filter_;
   // Norm of the accelerometer for the previous measurement.
   double previous_accelerometer_norm_;
   // Moving average of the accelerometer norm changes. It is computed for every
@@ -172,6 +349,13 @@ class SensorFusionEkf {
   // accelerometer sample.
   std::atomic<bool> execute_reset_with_next_accelerometer_sample_;
 
+  // Whether samples are being replayed, between BeginReplay() and
+  // EndReplay().
+  bool is_replaying_;
+
+  // Motion model used by PredictRotation().
+  std::atomic<RotationPredictionModel> rotation_prediction_model_;
+
   mutable std::mutex mutex_;
 
   // Bias estimator and static device detector.
@@ -180,10 +364,31 @@ class SensorFusionEkf {
   // Current bias estimate_;
   Vector3 gyroscope_bias_estimate_;
 
-  SensorFusionEkf(const SensorFusionEkf&) = delete;
-  SensorFusionEkf& operator=(const SensorFusionEkf&) = delete;
+  // Selected by SetGyroscopeBiasEstimation(), and applied by the next reset.
+  std::atomic<GyroscopeBiasEstimation> gyroscope_bias_estimation_;
+  // Whether gyroscope_bias_estimate_ is a state of the filter since the last
+  // reset.
+  bool is_gyroscope_bias_in_state_;
+  // Covariance between the rotation error and the bias, and covariance of the
+  // bias, when the bias is a state.
+  MatrixType rotation_bias_covariance_;
+  SymmetricMatrixType gyroscope_bias_covariance_;
+
+  // Whether the analytic measurement Jacobian is cross-checked numerically.
+  bool is_measurement_jacobian_check_enabled_;
+  // Largest difference found by the measurement Jacobian cross-check.
+  double max_measurement_jacobian_error_;
+
+  BasicSensorFusionEkf(const BasicSensorFusionEkf&) = delete;
+  BasicSensorFusionEkf& operator=(const BasicSensorFusionEkf&) = delete;
 };
 
+typedef BasicSensorFusionEkf<double> SensorFusionEkf;
+typedef BasicSensorFusionEkf<float> FloatSensorFusionEkf;
+
+extern template class BasicSensorFusionEkf<double>;
+extern template class BasicSensorFusionEkf<float>;
+
 }  // namespace cardboard
 
 #endif  // CARDBOARD_SDK_SENSORS_SENSOR_FUSION_EKF_H_
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/sensor_fusion_replay.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+
+#include "sensors/sensor_fusion_ekf.h"
+
+namespace cardboard {
+
+template <typename SensorFusion>
+SensorFusionReplay<SensorFusion>::SensorFusionReplay(
+    SensorFusion* sensor_fusion, size_t sample_capacity,
+    size_t checkpoint_interval)
+    : sensor_fusion_(sensor_fusion),
+      checkpoint_interval_(checkpoint_interval),
+      samples_(sample_capacity),
+      checkpoints_(sample_capacity / checkpoint_interval + 1),
+      next_sample_(0),
+      statistics_{} {}
+
+template <typename SensorFusion>
+void SensorFusionReplay<SensorFusion>::Clear() {
+  samples_.Clear();
+  checkpoints_.Clear();
+}
+
+template <typename SensorFusion>
+void SensorFusionReplay<SensorFusion>::ProcessAccelerometerSample(
+    const AccelerometerData& sample) {
+  sensor_fusion_->ProcessAccelerometerSample(sample);
+  Record({false, sample.system_timestamp, sample.sensor_timestamp_ns,
+          sample.data});
+}
+
+template <typename SensorFusion>
+void SensorFusionReplay<SensorFusion>::ProcessGyroscopeSample(
+    const GyroscopeData& sample) {
+  sensor_fusion_->ProcessGyroscopeSample(sample);
+  Record({true, sample.system_timestamp, sample.sensor_timestamp_ns,
+          sample.data});
+}
+
+template <typename SensorFusion>
+void SensorFusionReplay<SensorFusion>::Record(const Sample& sample) {
+  samples_.Push(sample);
+  ++next_sample_;
+
+  // Checkpoints can only be replayed from while the samples after them are
+  // buffered.
+  const uint64_t oldest_sample = next_sample_ - samples_.Size();
+  while (!checkpoints_.IsEmpty() &&
+         checkpoints_.Front().next_sample < oldest_sample) {
+    checkpoints_.PopFront();
+  }
+
+  if (next_sample_ % checkpoint_interval_ == 0) {
+    Checkpoint checkpoint;
+    sensor_fusion_->SaveCheckpoint(&checkpoint.state);
+    checkpoint.timestamp = sample.system_timestamp;
+    checkpoint.next_sample = next_sample_;
+    checkpoints_.Push(checkpoint);
+  }
+}
+
+template <typename SensorFusion>
+void SensorFusionReplay<SensorFusion>::Process(const Sample& sample) {
+  if (sample.is_gyroscope) {
+    sensor_fusion_->ProcessGyroscopeSample(
+        {sample.system_timestamp, sample.sensor_timestamp_ns, sample.data});
+  } else {
+    sensor_fusion_->ProcessAccelerometerSample(
+        {sample.system_timestamp, sample.sensor_timestamp_ns, sample.data});
+  }
+}
+
+template <typename SensorFusion>
+bool SensorFusionReplay<SensorFusion>::ApplyRotationMeasurement(
+    const RotationType& sensor_from_start_rotation, int64_t timestamp) {
+  if (checkpoints_.IsEmpty() ||
+      timestamp < static_cast<int64_t>(checkpoints_.Front().timestamp)) {
+    ++statistics_.rejected_measurements;
+    return false;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+
+  // Latest checkpoint not after the measurement. The checkpoints after it
+  // hold states that the measurement changes, and are saved again while
+  // replaying.
+  size_t checkpoint = checkpoints_.Size() - 1;
+  while (static_cast<int64_t>(checkpoints_[checkpoint].timestamp) >
+         timestamp) {
+    --checkpoint;
+  }
+  size_t next_checkpoint = checkpoint + 1;
+
+  const uint64_t oldest_sample = next_sample_ - samples_.Size();
+  uint64_t sample = checkpoints_[checkpoint].next_sample;
+  sensor_fusion_->BeginReplay(checkpoints_[checkpoint].state);
+  for (; sample < next_sample_; ++sample) {
+    const Sample& replayed_sample = samples_[sample - oldest_sample];
+    if (static_cast<int64_t>(replayed_sample.system_timestamp) > timestamp) {
+      break;
+    }
+    Process(replayed_sample);
+  }
+  sensor_fusion_->ProcessRotationMeasurement(sensor_from_start_rotation,
+                                             timestamp);
+  const int replayed_samples =
+      static_cast<int>(next_sample_ - checkpoints_[checkpoint].next_sample);
+  while (sample < next_sample_) {
+    Process(samples_[sample - oldest_sample]);
+    ++sample;
+    if (next_checkpoint < checkpoints_.Size() &&
+        checkpoints_[next_checkpoint].next_sample == sample) {
+      sensor_fusion_->SaveCheckpoint(&checkpoints_[next_checkpoint].state);
+      ++next_checkpoint;
+    }
+  }
+  sensor_fusion_->EndReplay();
+
+  const int64_t duration_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+  ++statistics_.applied_measurements;
+  statistics_.last_replayed_samples = replayed_samples;
+  statistics_.max_replayed_samples =
+      std::max(statistics_.max_replayed_samples, replayed_samples);
+  statistics_.last_replay_duration_ns = duration_ns;
+  statistics_.max_replay_duration_ns =
+      std::max(statistics_.max_replay_duration_ns, duration_ns);
+  return true;
+}
+
+template class SensorFusionReplay<SensorFusionEkf>;
+template class SensorFusionReplay<FloatSensorFusionEkf>;
+
+}  // namespace cardboard
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_SENSOR_FUSION_REPLAY_H_
+#define CARDBOARD_SDK_SENSORS_SENSOR_FUSION_REPLAY_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sensors/accelerometer_data.h"
+#include "sensors/gyroscope_data.h"
+#include "util/ring_buffer.h"
+#include "util/vector.h"
+
+namespace cardboard {
+
+// Counts and costs of the measurements applied by a SensorFusionReplay.
+struct SensorFusionReplayStatistics {
+  // Number of measurements applied, and of measurements older than the
+  // buffered samples, which are dropped.
+  int64_t applied_measurements;
+  int64_t rejected_measurements;
+  // Number of samples replayed for the last measurement and at most.
+  int last_replayed_samples;
+  int max_replayed_samples;
+  // Time taken to rewind and replay for the last measurement and at most.
+  int64_t last_replay_duration_ns;
+  int64_t max_replay_duration_ns;
+};
+
+// Feeds the IMU samples to a sensor fusion and keeps the latest ones, together
+// with checkpoints of the filter state, so that measurements which arrive late
+// can be applied at the time they were taken.
+//
+// A delayed measurement rewinds the filter to the last checkpoint before it,
+// replays the samples up to its timestamp, is applied, and the remaining
+// samples are replayed to bring the filter back to the present. The cost of
+// a replay is bounded by the number of buffered samples; the number of
+// replayed samples and the time taken are recorded in the statistics.
+//
+// This class is not thread safe: the samples and the measurements must be
+// given from one thread at a time.
+template <typename SensorFusion>
+class SensorFusionReplay {
+ public:
+  typedef typename SensorFusion::RotationType RotationType;
+  typedef SensorFusionReplayStatistics Statistics;
+
+  // @param sensor_fusion filter fed by this class, which must outlive it.
+  // @param sample_capacity number of samples kept. It bounds both how late a
+  //        measurement can be and the number of samples a replay processes.
+  // @param checkpoint_interval number of samples between two checkpoints.
+  //        Up to this many samples are replayed in addition to those after
+  //        the measurement.
+  SensorFusionReplay(SensorFusion* sensor_fusion, size_t sample_capacity,
+                     size_t checkpoint_interval);
+
+  // Discards the buffered samples and checkpoints, e.g. after the filter has
+  // been reset or its start space rotated.
+  void Clear();
+
+  // @{ Processes a live sample with the sensor fusion and records it.
+  void ProcessAccelerometerSample(const AccelerometerData& sample);
+  void ProcessGyroscopeSample(const GyroscopeData& sample);
+  // @}
+
+  // Corrects the rotation of the sensor fusion with
+  // @p sensor_from_start_rotation at @p timestamp, and replays the samples
+  // processed since.
+  //
+  // @param sensor_from_start_rotation measured rotation from Start to Sensor
+  //        Space.
+  // @param timestamp system time of the measurement.
+  // @return false if @p timestamp is older than the oldest checkpoint, in
+  //         which case the measurement is dropped.
+  bool ApplyRotationMeasurement(const RotationType& sensor_from_start_rotation,
+                                int64_t timestamp);
+
+  Statistics GetStatistics() const { return statistics_; }
+
+ private:
+  struct Sample {
+    bool is_gyroscope;
+    uint64_t system_timestamp;
+    uint64_t sensor_timestamp_ns;
+    Vector3 data;
+  };
+
+  struct Checkpoint {
+    typename SensorFusion::Checkpoint state;
+    // System time of the last sample processed before the checkpoint.
+    uint64_t timestamp;
+    // Index, counted since the construction, of the first sample processed
+    // after the checkpoint.
+    uint64_t next_sample;
+  };
+
+  // Records a processed sample and saves a checkpoint every
+  // checkpoint_interval_ samples.
+  void Record(const Sample& sample);
+
+  // Feeds @p sample to the sensor fusion.
+  void Process(const Sample& sample);
+
+  SensorFusion* const sensor_fusion_;
+  const size_t checkpoint_interval_;
+  RingBuffer<Sample> samples_;
+  RingBuffer<Checkpoint> checkpoints_;
+  // Index of the next sample to be recorded.
+  uint64_t next_sample_;
+  Statistics statistics_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_SENSOR_FUSION_REPLAY_H_
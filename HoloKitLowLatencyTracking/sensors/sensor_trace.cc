@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensors/sensor_trace.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>  // NOLINT
+#include <sstream>  // NOLINT
+
+#include "util/logging.h"
+
+namespace cardboard {
+
+namespace {
+
+// Splits @p line on commas.
+std::vector<std::string> SplitFields(const std::string& line) {
+  std::vector<std::string> fields;
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+// Parses @p count floating point values starting at @p fields[2 + offset],
+// i.e. after the sample type and timestamp fields.
+bool ParseValues(const std::vector<std::string>& fields, size_t offset,
+                 size_t count, double* values) {
+  for (size_t i = 0; i < count; ++i) {
+    char* end = nullptr;
+    const std::string& field = fields[2 + offset + i];
+    values[i] = std::strtod(field.c_str(), &end);
+    if (end == field.c_str()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename DataType>
+bool IsEarlier(const DataType& a, const DataType& b) {
+  return a.sensor_timestamp_ns < b.sensor_timestamp_ns;
+}
+
+}  // namespace
+
+std::unique_ptr<SensorTrace> SensorTrace::LoadFromFile(
+    const std::string& path) {
+  std::ifstream input(path);
+  if (!input) {
+    CARDBOARD_LOGE("Cannot open sensor trace %s.\n", path.c_str());
+    return nullptr;
+  }
+  return LoadFromStream(input);
+}
+
+std::unique_ptr<SensorTrace> SensorTrace::LoadFromStream(std::istream& input) {
+  std::unique_ptr<SensorTrace> trace(new SensorTrace());
+  std::string line;
+  int line_number = 0;
+  while (std::getline(input, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#' || line[0] == '\r') {
+      continue;
+    }
+
+    const std::vector<std::string> fields = SplitFields(line);
+    const size_t expected_fields = fields[0] == "P" ? 9 : 5;
+    if ((fields[0] != "A" && fields[0] != "G" && fields[0] != "P") ||
+        fields.size() != expected_fields) {
+      CARDBOARD_LOGE("Malformed sensor trace line %d.\n", line_number);
+      return nullptr;
+    }
+
+    const uint64_t timestamp_ns = std::strtoull(fields[1].c_str(), nullptr, 10);
+    double values[7];
+    if (!ParseValues(fields, 0, expected_fields - 2, values)) {
+      CARDBOARD_LOGE("Malformed sensor trace line %d.\n", line_number);
+      return nullptr;
+    }
+
+    if (fields[0] == "A") {
+      trace->AddAccelerometerSample(
+          {0, timestamp_ns, Vector3(values[0], values[1], values[2])});
+    } else if (fields[0] == "G") {
+      trace->AddGyroscopeSample(
+          {0, timestamp_ns, Vector3(values[0], values[1], values[2])});
+    } else {
+      SixDoFData sample;
+      sample.sensor_timestamp_ns = timestamp_ns;
+      for (int i = 0; i < 3; ++i) {
+        sample.position[i] = static_cast<float>(values[i]);
+      }
+      for (int i = 0; i < 4; ++i) {
+        sample.orientation[i] = static_cast<float>(values[3 + i]);
+      }
+      trace->AddSixDoFSample(sample);
+    }
+  }
+
+  trace->Sort();
+  return trace;
+}
+
+void SensorTrace::AddAccelerometerSample(const AccelerometerData& sample) {
+  accelerometer_samples_.push_back(sample);
+  accelerometer_samples_.back().system_timestamp = sample.sensor_timestamp_ns;
+}
+
+void SensorTrace::AddGyroscopeSample(const GyroscopeData& sample) {
+  gyroscope_samples_.push_back(sample);
+  gyroscope_samples_.back().system_timestamp = sample.sensor_timestamp_ns;
+}
+
+void SensorTrace::AddSixDoFSample(const SixDoFData& sample) {
+  sixdof_samples_.push_back(sample);
+  sixdof_samples_.back().system_timestamp = sample.sensor_timestamp_ns;
+}
+
+void SensorTrace::Sort() {
+  std::stable_sort(accelerometer_samples_.begin(), accelerometer_samples_.end(),
+                   IsEarlier<AccelerometerData>);
+  std::stable_sort(gyroscope_samples_.begin(), gyroscope_samples_.end(),
+                   IsEarlier<GyroscopeData>);
+  std::stable_sort(sixdof_samples_.begin(), sixdof_samples_.end(),
+                   IsEarlier<SixDoFData>);
+}
+
+int64_t SensorTrace::GetStartTimestamp() const {
+  uint64_t start = UINT64_MAX;
+  if (!accelerometer_samples_.empty()) {
+    start = std::min(start, accelerometer_samples_.front().sensor_timestamp_ns);
+  }
+  if (!gyroscope_samples_.empty()) {
+    start = std::min(start, gyroscope_samples_.front().sensor_timestamp_ns);
+  }
+  if (!sixdof_samples_.empty()) {
+    start = std::min(start, sixdof_samples_.front().sensor_timestamp_ns);
+  }
+  return start == UINT64_MAX ? 0 : static_cast<int64_t>(start);
+}
+
+int64_t SensorTrace::GetEndTimestamp() const {
+  uint64_t end = 0;
+  if (!accelerometer_samples_.empty()) {
+    end = std::max(end, accelerometer_samples_.back().sensor_timestamp_ns);
+  }
+  if (!gyroscope_samples_.empty()) {
+    end = std::max(end, gyroscope_samples_.back().sensor_timestamp_ns);
+  }
+  if (!sixdof_samples_.empty()) {
+    end = std::max(end, sixdof_samples_.back().sensor_timestamp_ns);
+  }
+  return static_cast<int64_t>(end);
+}
+
+}  // namespace cardboard
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_SENSOR_TRACE_H_
+#define CARDBOARD_SDK_SENSORS_SENSOR_TRACE_H_
+
+#include <cstdint>
+#include <istream>  // NOLINT
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sensors/accelerometer_data.h"
+#include "sensors/gyroscope_data.h"
+#include "sensors/sixdof_data.h"
+
+namespace cardboard {
+
+// Recorded accelerometer, gyroscope and 6DoF samples, used to replay a
+// session on platforms without device sensors.
+//
+// The text format has one sample per line, fields separated by commas:
+//
+// @code
+// A,<timestamp_ns>,<x>,<y>,<z>                        accelerometer (m/s^2)
+// G,<timestamp_ns>,<x>,<y>,<z>                        gyroscope (rad/s)
+// P,<timestamp_ns>,<px>,<py>,<pz>,<qx>,<qy>,<qz>,<qw>  6DoF pose
+// @endcode
+//
+// Empty lines and lines starting with '#' are ignored. Timestamps are on the
+// sensor clock, which on iOS is also the system clock. Samples of each type
+// are sorted by timestamp when loaded.
+class SensorTrace {
+ public:
+  SensorTrace() = default;
+
+  // Loads a trace from a file.
+  //
+  // @param path path of the trace file.
+  // @return the trace, or nullptr if the file cannot be read or contains a
+  //         malformed line.
+  static std::unique_ptr<SensorTrace> LoadFromFile(const std::string& path);
+
+  // Loads a trace from a stream.
+  //
+  // @param input stream to read the trace from.
+  // @return the trace, or nullptr if the stream contains a malformed line.
+  static std::unique_ptr<SensorTrace> LoadFromStream(std::istream& input);
+
+  // Appends samples. The system timestamp of the sample is set to its sensor
+  // timestamp.
+  void AddAccelerometerSample(const AccelerometerData& sample);
+  void AddGyroscopeSample(const GyroscopeData& sample);
+  void AddSixDoFSample(const SixDoFData& sample);
+
+  // Sorts the samples of each type by timestamp.
+  void Sort();
+
+  // @{ Returns the recorded samples sorted by timestamp.
+  const std::vector<AccelerometerData>& GetAccelerometerSamples() const {
+    return accelerometer_samples_;
+  }
+  const std::vector<GyroscopeData>& GetGyroscopeSamples() const {
+    return gyroscope_samples_;
+  }
+  const std::vector<SixDoFData>& GetSixDoFSamples() const {
+    return sixdof_samples_;
+  }
+  // @}
+
+  // Returns the given type of samples. Used by code that is templated on the
+  // sensor data type.
+  template <typename DataType>
+  const std::vector<DataType>& GetSamples() const;
+
+  // @{ Returns the timestamp of the first and last sample of any type, or zero
+  // if the trace is empty.
+  int64_t GetStartTimestamp() const;
+  int64_t GetEndTimestamp() const;
+  // @}
+
+ private:
+  std::vector<AccelerometerData> accelerometer_samples_;
+  std::vector<GyroscopeData> gyroscope_samples_;
+  std::vector<SixDoFData> sixdof_samples_;
+};
+
+template <>
+inline const std::vector<AccelerometerData>&
+SensorTrace::GetSamples<AccelerometerData>() const {
+  return accelerometer_samples_;
+}
+
+template <>
+inline const std::vector<GyroscopeData>&
+SensorTrace::GetSamples<GyroscopeData>() const {
+  return gyroscope_samples_;
+}
+
+template <>
+inline const std::vector<SixDoFData>& SensorTrace::GetSamples<SixDoFData>()
+    const {
+  return sixdof_samples_;
+}
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_SENSOR_TRACE_H_
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SENSORS_SIXDOF_DATA_H_
+#define CARDBOARD_SDK_SENSORS_SIXDOF_DATA_H_
+
+#include <array>
+#include <cstdint>
+
+namespace cardboard {
+
+// Aryzon 6DoF
+//
+// A 6DoF pose sample as delivered by ARKit, in Cardboard space (i.e. after the
+// Unity to Cardboard conversion done by CardboardInputApi::AddSixDoFData).
+struct SixDoFData {
+  // System wall time.
+  uint64_t system_timestamp;
+
+  // Capture time of the pose in nanoseconds.
+  uint64_t sensor_timestamp_ns;
+
+  // Position in meters.
+  std::array<float, 3> position;
+
+  // Orientation as a quaternion, with the scalar part in the last element.
+  std::array<float, 4> orientation;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SENSORS_SIXDOF_DATA_H_
@@ -15,69 +15,162 @@
  */
 #include "sixdof/position_data.h"
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <sstream>
 #include "util/logging.h"
 
 namespace cardboard {
 
-PositionData::PositionData(size_t buffer_size) : buffer_size_(buffer_size) {}
+namespace {
 
-void PositionData::AddSample(const Vector3& sample, const int64_t timestamp_ns) {
-    
-    buffer_.push_back(sample);
-    
-    if (buffer_.size() > buffer_size_) {
-        buffer_.pop_front();
+// Time constant of the exponential decay of the sample weights.
+constexpr double kDefaultWeightTimeConstant_s = 0.05;
+
+// Fits whose normal equations have a determinant below this fraction of the
+// product of their diagonal are degenerate, e.g. all samples have the same
+// timestamp.
+constexpr double kMinimumRelativeDeterminant = 1e-9;
+
+constexpr double kNanosToSeconds = 1e-9;
+
+// Solves the normal equations of a first degree fit, given the weighted sums
+// s[k] = sum(w x^k) and r[k] = sum(w x^k p). Leaves @p coefficients unchanged
+// and returns false if they are degenerate.
+bool SolveLinearFit(const double s[5], const Vector3 r[3],
+                    Vector3 coefficients[3]) {
+    const double determinant = s[0] * s[2] - s[1] * s[1];
+    if (determinant <= kMinimumRelativeDeterminant * s[0] * s[2]) {
+        return false;
     }
-    
-    timestamp_buffer_.push_back(timestamp_ns);
-    if (timestamp_buffer_.size() > buffer_size_) {
-        timestamp_buffer_.pop_front();
+    coefficients[0] = (s[2] * r[0] - s[1] * r[1]) / determinant;
+    coefficients[1] = (s[0] * r[1] - s[1] * r[0]) / determinant;
+    coefficients[2] = Vector3::Zero();
+    return true;
+}
+
+// Same as SolveLinearFit() for a second degree fit.
+bool SolveQuadraticFit(const double s[5], const Vector3 r[3],
+                       Vector3 coefficients[3]) {
+    // Adjugate of the symmetric matrix of the normal equations.
+    const double a00 = s[2] * s[4] - s[3] * s[3];
+    const double a01 = s[2] * s[3] - s[1] * s[4];
+    const double a02 = s[1] * s[3] - s[2] * s[2];
+    const double a11 = s[0] * s[4] - s[2] * s[2];
+    const double a12 = s[1] * s[2] - s[0] * s[3];
+    const double a22 = s[0] * s[2] - s[1] * s[1];
+    const double determinant = s[0] * a00 + s[1] * a01 + s[2] * a02;
+    if (determinant <= kMinimumRelativeDeterminant * s[0] * s[2] * s[4]) {
+        return false;
     }
+    coefficients[0] = (a00 * r[0] + a01 * r[1] + a02 * r[2]) / determinant;
+    coefficients[1] = (a01 * r[0] + a11 * r[1] + a12 * r[2]) / determinant;
+    coefficients[2] = (a02 * r[0] + a12 * r[1] + a22 * r[2]) / determinant;
+    return true;
+}
+
+}  // namespace
+
+PositionData::PositionData(size_t buffer_size)
+    : buffer_(buffer_size),
+      model_(Model::kConstantVelocity),
+      weight_time_constant_s_(kDefaultWeightTimeConstant_s) {
+    UpdateFit();
+}
+
+void PositionData::AddSample(const Vector3& sample, const int64_t timestamp_ns) {
+    buffer_.Push({sample, timestamp_ns});
+    UpdateFit();
 }
 
-bool PositionData::IsValid() const { return buffer_.size() == buffer_size_; }
+bool PositionData::IsValid() const { return published_fit_.Load().is_valid; }
 
 long long PositionData::GetLatestTimestamp() const {
-    if (timestamp_buffer_.size() > 0) {
-        return timestamp_buffer_[timestamp_buffer_.size() -1];
-    }
-    return 0;
+    return published_fit_.Load().timestamp_ns;
 }
 
 Vector3 PositionData::GetLatestData() const {
-    if (buffer_.size() > 0) {
-        return buffer_[buffer_.size() -1];
-    }
-    return Vector3::Zero();
+    return published_fit_.Load().latest_position;
 }
 
 
-Vector3 PositionData::GetExtrapolatedForTimeStamp(const int64_t timestamp_ns) {
-  
-    if (!IsValid() || buffer_size_ < 2) {
+Vector3 PositionData::GetExtrapolatedForTimeStamp(const int64_t timestamp_ns) const {
+    // The fit is loaded once, so that its coefficients and timestamp come
+    // from the same sample even while AddSample() runs on another thread.
+    const Fit fit = published_fit_.Load();
+    if (!fit.is_valid) {
         return {0.0,0.0,0.0};
     }
     
-    if (timestamp_ns > timestamp_buffer_[buffer_size_-1]) {
-        const Vector3 v0 = (buffer_[buffer_size_-1] - buffer_[buffer_size_-2]) / (timestamp_buffer_[buffer_size_-1] - timestamp_buffer_[buffer_size_-2]);
-        const Vector3 v1 = (buffer_[buffer_size_-2] - buffer_[buffer_size_-3]) / (timestamp_buffer_[buffer_size_-2] - timestamp_buffer_[buffer_size_-3]);
-        const Vector3 v2 = (buffer_[buffer_size_-3] - buffer_[buffer_size_-4]) / (timestamp_buffer_[buffer_size_-3] - timestamp_buffer_[buffer_size_-4]);
-        const Vector3 v3 = (buffer_[buffer_size_-4] - buffer_[buffer_size_-5]) / (timestamp_buffer_[buffer_size_-4] - timestamp_buffer_[buffer_size_-5]);
-        const Vector3 v4 = (buffer_[buffer_size_-5] - buffer_[buffer_size_-6]) / (timestamp_buffer_[buffer_size_-5] - timestamp_buffer_[buffer_size_-6]);
-        
-        const Vector3 v = (v0 + v1 + v2 + v3 + v4) / 5;
-        
-        //printf("v\t%f\t%llu\t%llu\t%llu\t%f\t%f\t%f\n", v[0] * 1000000,timestamp_buffer_[buffer_size_ - 1],timestamp_buffer_[buffer_size_ - 2],timestamp_ns, newPoss[0], newPoss[1], newPoss[2]);
-        return buffer_[buffer_size_-1] + v * (timestamp_ns - timestamp_buffer_[buffer_size_ - 1]);
+    if (timestamp_ns > fit.timestamp_ns) {
+        const double dt = (timestamp_ns - fit.timestamp_ns) * kNanosToSeconds;
+        return fit.coefficients[0] +
+               dt * (fit.coefficients[1] + dt * fit.coefficients[2]);
     }
-    return buffer_[buffer_size_-1];
+    return fit.coefficients[0];
+}
+
+void PositionData::SetModel(Model model) {
+    model_ = model;
+    UpdateFit();
+}
+
+PositionData::Model PositionData::GetModel() const { return model_; }
+
+void PositionData::SetWeightTimeConstant(double time_constant_s) {
+    weight_time_constant_s_ = time_constant_s;
+    UpdateFit();
 }
 
 void PositionData::Reset() {
-    buffer_.clear();
-    timestamp_buffer_.clear();
+    buffer_.Clear();
+    UpdateFit();
+}
+
+void PositionData::UpdateFit() {
+    Fit fit;
+    fit.latest_position =
+        buffer_.IsEmpty() ? Vector3::Zero() : buffer_.Back().position;
+    fit.timestamp_ns = buffer_.IsEmpty() ? 0 : buffer_.Back().timestamp_ns;
+    fit.is_valid = buffer_.IsFull();
+    fit.coefficients[0] = fit.latest_position;
+    fit.coefficients[1] = Vector3::Zero();
+    fit.coefficients[2] = Vector3::Zero();
+
+    const size_t degree = std::min<size_t>(
+        model_ == Model::kConstantAcceleration ? 2 : 1,
+        buffer_.IsEmpty() ? 0 : buffer_.Size() - 1);
+    if (degree == 0) {
+        published_fit_.Store(fit);
+        return;
+    }
+
+    // Weighted sums of the powers of the sample times, s[k] = sum(w x^k), and
+    // of the positions, r[k] = sum(w x^k p), forming the normal equations.
+    // Times are relative to the latest sample to keep them small.
+    double s[5] = {0, 0, 0, 0, 0};
+    Vector3 r[3] = {Vector3::Zero(), Vector3::Zero(), Vector3::Zero()};
+    for (size_t i = 0; i < buffer_.Size(); ++i) {
+        const double x =
+            (buffer_[i].timestamp_ns - fit.timestamp_ns) * kNanosToSeconds;
+        double power = std::exp(x / weight_time_constant_s_);
+        for (size_t k = 0; k <= 2 * degree; ++k) {
+            s[k] += power;
+            if (k <= degree) {
+                r[k] += power * buffer_[i].position;
+            }
+            power *= x;
+        }
+    }
+
+    // A degenerate second degree fit, e.g. when the sample times are too
+    // close together to tell an acceleration, falls back to a line, and a
+    // degenerate line to the latest sample.
+    if (degree < 2 || !SolveQuadraticFit(s, r, fit.coefficients)) {
+        SolveLinearFit(s, r, fit.coefficients);
+    }
+    published_fit_.Store(fit);
 }
 
 }  // namespace cardboard
@@ -19,17 +19,41 @@
 #ifndef position_data_h
 #define position_data_h
 
-#include <deque>
+#include <cstddef>
+#include <cstdint>
 
+#include "util/ring_buffer.h"
+#include "util/seqlock.h"
 #include "util/vector.h"
 
 namespace cardboard {
 
 // This class holds a buffer of position data samples with corresponding timestamp samples
+//
+// The position is extrapolated from a weighted least-squares fit of a
+// polynomial of the time to all the buffered samples. The weights decay
+// exponentially with the age of the samples, so that the fit follows changes
+// of the motion while averaging out the jitter of the individual samples. The
+// fit is updated when a sample is added, so that extrapolating costs the same
+// whatever the number of samples.
+//
+// AddSample(), SetModel(), SetWeightTimeConstant() and Reset() must be called
+// from one thread at a time. IsValid(), GetLatestData(), GetLatestTimestamp()
+// and GetExtrapolatedForTimeStamp() read the latest published fit and can be
+// called from any thread.
 class PositionData {
  public:
+  // Motion model of the fitted polynomial.
+  enum class Model {
+    // First degree polynomial.
+    kConstantVelocity,
+    // Second degree polynomial. Follows accelerations with less lag but
+    // amplifies the jitter more when extrapolating far ahead.
+    kConstantAcceleration,
+  };
+
   // Create a buffer to hold position data of size buffer_size.
-  // @param buffer_size size of samples to buffer.
+  // @param buffer_size size of samples to buffer, the window of the fit.
   explicit PositionData(size_t buffer_size);
 
   // Add sample to buffer_ if buffer_ is full it drop the oldest sample.
@@ -45,17 +69,48 @@ class PositionData {
   long long GetLatestTimestamp() const;
     
   // Returns the position extrapolated from data stored in the internal buffers.
-  // A buffer size of 2 is required to work.
-  // It returns a zero Vector3 when not fully initialised.
+  // It returns a zero Vector3 when not fully initialised, and the fitted
+  // position at the latest sample for timestamps before it.
   // @param timestamp_ns the time in nanoseconds to get a position value for.
-  Vector3 GetExtrapolatedForTimeStamp(const int64_t timestamp_ns);
+  Vector3 GetExtrapolatedForTimeStamp(const int64_t timestamp_ns) const;
+
+  // Selects the model of the fit. Models needing more samples than the buffer
+  // holds fall back to a lower degree.
+  void SetModel(Model model);
+  Model GetModel() const;
+
+  // Sets the time constant of the exponential decay of the sample weights.
+  // @param time_constant_s time constant in seconds. Infinity weights all the
+  //        samples equally.
+  void SetWeightTimeConstant(double time_constant_s);
   
   // Clear the internal buffers.
   void Reset();
  private:
-  const size_t buffer_size_;
-  std::deque<Vector3> buffer_;
-  std::deque<int64_t> timestamp_buffer_;
+  struct Sample {
+    Vector3 position;
+    int64_t timestamp_ns;
+  };
+
+  struct Fit {
+    // Coefficients of the fitted polynomial of the time in seconds since
+    // timestamp_ns: position, velocity and half the acceleration.
+    Vector3 coefficients[3];
+    // Latest sample.
+    Vector3 latest_position;
+    int64_t timestamp_ns;
+    // True if the buffer is full.
+    bool is_valid;
+  };
+
+  // Fits the polynomial to the buffered samples and publishes it.
+  void UpdateFit();
+
+  RingBuffer<Sample> buffer_;
+  Model model_;
+  double weight_time_constant_s_;
+
+  SeqLock<Fit> published_fit_;
 };
 
 }  // namespace cardboard
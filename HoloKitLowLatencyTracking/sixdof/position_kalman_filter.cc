@@ -0,0 +1,223 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sixdof/position_kalman_filter.h"
+
+#include <cstddef>
+
+#include "util/matrixutils.h"
+#include "util/vectorutils.h"
+
+namespace cardboard {
+
+namespace {
+
+// Number of states kept, a bit more than a second of accelerometer samples at
+// 100 Hz plus the positions, several times the 6DoF latency.
+constexpr size_t kHistorySize = 192;
+// Accelerations or positions further apart than this are not integrated over,
+// e.g. after the sensors were paused, and the filter restarts.
+constexpr int64_t kMaximumSampleGapNs = 100000000;
+
+// Kalman filter noise parameters.
+constexpr double kPositionStdDev = 2e-3;
+// White noise of the accelerations, in m/s^2/sqrt(Hz). It also covers the
+// accelerations of the camera that the IMU does not see because of the lever
+// arm between them, and the orientation errors.
+constexpr double kAccelerationNoise = 0.3;
+// Random walk of the acceleration bias, in m/s^2/sqrt(s).
+constexpr double kAccelerationBiasRandomWalk = 0.02;
+// Initial standard deviations of the velocity and of the bias.
+constexpr double kInitialVelocityStdDev = 0.5;
+constexpr double kInitialAccelerationBiasStdDev = 0.2;
+// Positions further than this many standard deviations from the estimate are
+// rejected, unless kMaximumRejectedPositions follow each other.
+constexpr double kOutlierThreshold = 5;
+constexpr int kMaximumRejectedPositions = 3;
+
+constexpr double kNanosToSeconds = 1e-9;
+
+constexpr PositionKalmanFilter::State kInvalidState = {
+    {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, 0, false};
+
+// Integrates @p acceleration up to @p timestamp_ns.
+void Propagate(const Vector3& acceleration, int64_t timestamp_ns,
+               PositionKalmanFilter::State* state, Matrix3x3* covariance) {
+  const double dt =
+      static_cast<double>(timestamp_ns - state->timestamp_ns) *
+      kNanosToSeconds;
+  const Vector3 corrected_acceleration =
+      acceleration - state->acceleration_bias;
+  state->position +=
+      state->velocity * dt + corrected_acceleration * (0.5 * dt * dt);
+  state->velocity += corrected_acceleration * dt;
+  state->timestamp_ns = timestamp_ns;
+
+  const Matrix3x3 transition(1, dt, -0.5 * dt * dt,  //
+                             0, 1, -dt,              //
+                             0, 0, 1);
+  const double acceleration_variance = kAccelerationNoise * kAccelerationNoise;
+  const double dt2 = dt * dt;
+  const Matrix3x3 process_noise(
+      acceleration_variance * dt2 * dt / 3, acceleration_variance * dt2 / 2, 0,
+      acceleration_variance * dt2 / 2, acceleration_variance * dt, 0,  //
+      0, 0, kAccelerationBiasRandomWalk * kAccelerationBiasRandomWalk * dt);
+  *covariance =
+      transition * *covariance * Transpose(transition) + process_noise;
+}
+
+}  // namespace
+
+PositionKalmanFilter::PositionKalmanFilter()
+    : history_(kHistorySize),
+      rejected_positions_(0),
+      published_state_(kInvalidState) {}
+
+void PositionKalmanFilter::Reset() {
+  history_.Clear();
+  rejected_positions_ = 0;
+  published_state_.Store(kInvalidState);
+}
+
+void PositionKalmanFilter::AddAcceleration(int64_t timestamp_ns,
+                                           const Vector3& acceleration) {
+  if (history_.IsEmpty()) {
+    return;
+  }
+  Entry entry = history_.Back();
+  if (timestamp_ns <= entry.state.timestamp_ns) {
+    return;
+  }
+  if (timestamp_ns - entry.state.timestamp_ns > kMaximumSampleGapNs) {
+    Reset();
+    return;
+  }
+  Propagate(acceleration, timestamp_ns, &entry.state, &entry.covariance);
+  entry.acceleration = acceleration;
+  history_.Push(entry);
+  published_state_.Store(entry.state);
+}
+
+bool PositionKalmanFilter::AddPosition(int64_t timestamp_ns,
+                                       const Vector3& position) {
+  if (history_.IsEmpty() ||
+      timestamp_ns - history_.Back().state.timestamp_ns > kMaximumSampleGapNs) {
+    Restart(timestamp_ns, position);
+    return true;
+  }
+  if (timestamp_ns < history_.Front().state.timestamp_ns) {
+    return false;
+  }
+
+  // Latest state not after the position. The acceleration of the next one
+  // covers the interval the position falls in, and the latest acceleration is
+  // held after the last one.
+  size_t index = history_.Size() - 1;
+  while (history_[index].state.timestamp_ns > timestamp_ns) {
+    --index;
+  }
+  const size_t next_index = index + 1;
+  Entry entry = history_[index];
+  if (next_index < history_.Size()) {
+    entry.acceleration = history_[next_index].acceleration;
+  }
+  Propagate(entry.acceleration, timestamp_ns, &entry.state, &entry.covariance);
+
+  // Update. The innovations of the three axes have the same variance.
+  Matrix3x3& covariance = entry.covariance;
+  const Vector3 innovation = position - entry.state.position;
+  const double innovation_variance =
+      covariance(0, 0) + kPositionStdDev * kPositionStdDev;
+  if (LengthSquared(innovation) >
+      kOutlierThreshold * kOutlierThreshold * innovation_variance) {
+    if (++rejected_positions_ >= kMaximumRejectedPositions) {
+      Restart(timestamp_ns, position);
+      return true;
+    }
+    return false;
+  }
+  rejected_positions_ = 0;
+  const Vector3 gain(covariance(0, 0) / innovation_variance,
+                     covariance(1, 0) / innovation_variance,
+                     covariance(2, 0) / innovation_variance);
+  entry.state.position += innovation * gain[0];
+  entry.state.velocity += innovation * gain[1];
+  entry.state.acceleration_bias += innovation * gain[2];
+  const Vector3 first_row(covariance(0, 0), covariance(0, 1),
+                          covariance(0, 2));
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      covariance(row, col) -= gain[row] * first_row[col];
+    }
+  }
+
+  // The updated state replaces the one it was propagated from if they have
+  // the same timestamp, and is inserted after it otherwise, so that a later
+  // position in the same interval starts from it. The states after it are
+  // integrated again.
+  size_t updated_index = index;
+  if (entry.state.timestamp_ns == history_[index].state.timestamp_ns) {
+    history_[index] = entry;
+  } else {
+    // Inserting into a full history drops the oldest state.
+    updated_index = history_.IsFull() ? index : next_index;
+    history_.Insert(next_index, entry);
+  }
+  for (size_t i = updated_index + 1; i < history_.Size(); ++i) {
+    Propagate(history_[i].acceleration, history_[i].state.timestamp_ns,
+              &entry.state, &entry.covariance);
+    history_[i].state = entry.state;
+    history_[i].covariance = entry.covariance;
+  }
+  published_state_.Store(history_.Back().state);
+  return true;
+}
+
+PositionKalmanFilter::State PositionKalmanFilter::GetState() const {
+  return published_state_.Load();
+}
+
+bool PositionKalmanFilter::PredictPosition(int64_t timestamp_ns,
+                                           Vector3* position) const {
+  const State state = published_state_.Load();
+  if (!state.is_valid) {
+    return false;
+  }
+  const double dt =
+      timestamp_ns > state.timestamp_ns
+          ? static_cast<double>(timestamp_ns - state.timestamp_ns) *
+                kNanosToSeconds
+          : 0;
+  *position = state.position + state.velocity * dt;
+  return true;
+}
+
+void PositionKalmanFilter::Restart(int64_t timestamp_ns,
+                                   const Vector3& position) {
+  Entry entry;
+  entry.state = {position, Vector3::Zero(), Vector3::Zero(), timestamp_ns,
+                 true};
+  entry.covariance = Matrix3x3(
+      kPositionStdDev * kPositionStdDev, 0, 0,                 //
+      0, kInitialVelocityStdDev * kInitialVelocityStdDev, 0,  //
+      0, 0, kInitialAccelerationBiasStdDev * kInitialAccelerationBiasStdDev);
+  entry.acceleration = Vector3::Zero();
+  history_.Clear();
+  history_.Push(entry);
+  rejected_positions_ = 0;
+  published_state_.Store(entry.state);
+}
+
+}  // namespace cardboard
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SIXDOF_POSITION_KALMAN_FILTER_H_
+#define CARDBOARD_SDK_SIXDOF_POSITION_KALMAN_FILTER_H_
+
+#include <cstdint>
+
+#include "util/matrix_3x3.h"
+#include "util/ring_buffer.h"
+#include "util/seqlock.h"
+#include "util/vector.h"
+
+namespace cardboard {
+
+// Aryzon 6DoF
+//
+// Estimates the position from the accelerometer and the 6DoF positions.
+//
+// Each axis of the 6DoF world space has a position, velocity and
+// accelerometer bias state. The accelerations, rotated to the world space
+// with gravity removed, are integrated at IMU rate, and the 6DoF positions
+// correct the states at the time they were captured: the filter is rewound to
+// the last acceleration before the position and the accelerations after it
+// are integrated again. The axes share the same model, noises and measurement
+// times, so a single covariance serves the three of them.
+//
+// The bias state absorbs what the accelerations have in common over a few
+// seconds, i.e. the accelerometer bias, but also the gravity left by an
+// orientation error.
+//
+// AddAcceleration() and AddPosition() must be called from one thread at a
+// time. GetState() and PredictPosition() read the latest published state and
+// can be called from any thread.
+class PositionKalmanFilter {
+ public:
+  struct State {
+    // Position in meters and velocity in m/s in the 6DoF world space.
+    Vector3 position;
+    Vector3 velocity;
+    // Offset of the accelerations in m/s^2.
+    Vector3 acceleration_bias;
+    // IMU timestamp of the state.
+    int64_t timestamp_ns;
+    // False until the first position.
+    bool is_valid;
+  };
+
+  PositionKalmanFilter();
+
+  // Discards the state. The filter restarts from the next position.
+  void Reset();
+
+  // Integrates an acceleration sample. It is ignored until the first
+  // position, and when older than the state.
+  //
+  // @param timestamp_ns IMU timestamp of the sample.
+  // @param acceleration acceleration in the 6DoF world space, gravity
+  //        removed, in m/s^2.
+  void AddAcceleration(int64_t timestamp_ns, const Vector3& acceleration);
+
+  // Corrects the state with a position captured at @p timestamp_ns. A position
+  // far from the estimate is rejected, unless several follow each other, in
+  // which case the 6DoF tracking is assumed to have jumped and the filter
+  // restarts from it.
+  //
+  // @param timestamp_ns IMU timestamp of the capture.
+  // @param position 6DoF position in meters.
+  // @return false if the position is older than the buffered accelerations
+  //         or rejected.
+  bool AddPosition(int64_t timestamp_ns, const Vector3& position);
+
+  // Returns the latest state.
+  State GetState() const;
+
+  // Predicts the position at @p timestamp_ns from the latest state at
+  // constant velocity.
+  //
+  // @param timestamp_ns IMU timestamp. Earlier timestamps than the state
+  //        return its position.
+  // @param position the predicted position.
+  // @return false until the first position, in which case @p position is
+  //         left unchanged.
+  bool PredictPosition(int64_t timestamp_ns, Vector3* position) const;
+
+ private:
+  // State after an acceleration sample or a position, kept to apply the
+  // positions at their capture time.
+  struct Entry {
+    State state;
+    // Covariance of the position, velocity and bias of one axis.
+    Matrix3x3 covariance;
+    // Acceleration integrated up to state.timestamp_ns.
+    Vector3 acceleration;
+  };
+
+  // Restarts the filter from @p position at @p timestamp_ns.
+  void Restart(int64_t timestamp_ns, const Vector3& position);
+
+  RingBuffer<Entry> history_;
+  // Number of consecutive rejected positions.
+  int rejected_positions_;
+
+  SeqLock<State> published_state_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SIXDOF_POSITION_KALMAN_FILTER_H_
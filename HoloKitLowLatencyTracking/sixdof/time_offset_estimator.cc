@@ -0,0 +1,326 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sixdof/time_offset_estimator.h"
+
+#include <cmath>
+
+#include "util/vector.h"
+#include "util/vectorutils.h"
+
+namespace cardboard {
+
+namespace {
+
+// Number of EKF angular speeds kept, a bit more than the 6DoF window plus the
+// search range at IMU rates up to 200 Hz.
+constexpr size_t kImuHistorySize = 512;
+// Number of 6DoF angular speeds correlated, two seconds at 60 Hz.
+constexpr size_t kSixDoFHistorySize = 120;
+// Number of 6DoF samples between two offset measurements.
+constexpr int kSamplesPerMeasurement = 30;
+// Minimum number of 6DoF angular speeds inside the IMU history for a
+// measurement.
+constexpr size_t kMinimumCorrelatedSamples = 60;
+// 6DoF samples further apart than this are not differentiated.
+constexpr int64_t kMaximumSixDoFSampleGapNs = 100000000;
+
+// The offset is searched in [-kMaximumOffsetNs, kMaximumOffsetNs], first with
+// kCoarseStepNs steps, then with kFineStepNs steps around the coarse peak.
+constexpr int64_t kMaximumOffsetNs = 100000000;
+constexpr int64_t kCoarseStepNs = 4000000;
+constexpr int64_t kFineStepNs = 1000000;
+
+// Standard deviation of the 6DoF angular speed, in rad/s, below which the
+// motion is too weak for the correlation peak to be meaningful.
+constexpr double kMinimumAngularSpeedStdDev = 0.3;
+// Minimum normalized cross-correlation at the peak.
+constexpr double kMinimumCorrelation = 0.8;
+
+// Kalman filter noise parameters.
+constexpr double kMeasurementStdDevNs = 2e6;
+// Random walks of the offset, in ns/sqrt(s), and of the drift, in 1/sqrt(s).
+constexpr double kOffsetRandomWalk = 0.5e6;
+constexpr double kDriftRandomWalk = 1e-6;
+// Initial standard deviation of the drift, 100 ppm.
+constexpr double kInitialDriftStdDev = 1e-4;
+// Measurements further than this many standard deviations from the estimate
+// are rejected, unless kMaximumRejectedMeasurements follow each other, in
+// which case the offset is assumed to have changed and the filter restarts.
+constexpr double kOutlierThreshold = 5;
+constexpr int kMaximumRejectedMeasurements = 3;
+
+constexpr double kNanosToSeconds = 1e-9;
+
+constexpr SixDoFTimeOffsetEstimator::Estimate kInvalidEstimate = {
+    0, 0, 0, 0, false};
+
+}  // namespace
+
+SixDoFTimeOffsetEstimator::SixDoFTimeOffsetEstimator()
+    : imu_samples_(kImuHistorySize),
+      sixdof_samples_(kSixDoFHistorySize),
+      published_estimate_(kInvalidEstimate) {
+  imu_snapshot_.reserve(kImuHistorySize);
+  Reset();
+}
+
+void SixDoFTimeOffsetEstimator::Reset() {
+  {
+    std::lock_guard<std::mutex> lock(imu_mutex_);
+    imu_samples_.Clear();
+  }
+  sixdof_samples_.Clear();
+  previous_orientation_ = Rotation::Identity();
+  previous_timestamp_ns_ = 0;
+  samples_since_measurement_ = 0;
+  estimate_ = kInvalidEstimate;
+  covariance_[0][0] = covariance_[0][1] = 0;
+  covariance_[1][0] = covariance_[1][1] = 0;
+  rejected_measurements_ = 0;
+  published_estimate_.Store(estimate_);
+}
+
+void SixDoFTimeOffsetEstimator::AddAngularSpeed(int64_t timestamp_ns,
+                                                double angular_speed) {
+  std::lock_guard<std::mutex> lock(imu_mutex_);
+  if (!imu_samples_.IsEmpty() &&
+      imu_samples_.Back().timestamp_ns >= timestamp_ns) {
+    return;
+  }
+  imu_samples_.Push({timestamp_ns, angular_speed});
+}
+
+void SixDoFTimeOffsetEstimator::AddSixDoFOrientation(
+    int64_t timestamp_ns, const Rotation& orientation) {
+  const int64_t interval_ns = timestamp_ns - previous_timestamp_ns_;
+  if (previous_timestamp_ns_ != 0 && interval_ns > 0 &&
+      interval_ns <= kMaximumSixDoFSampleGapNs) {
+    const double angle =
+        Length((-previous_orientation_ * orientation).Log());
+    sixdof_samples_.Push(
+        {previous_timestamp_ns_ + interval_ns / 2,
+         angle / (static_cast<double>(interval_ns) * kNanosToSeconds)});
+  }
+  previous_orientation_ = orientation;
+  previous_timestamp_ns_ = timestamp_ns;
+
+  if (++samples_since_measurement_ < kSamplesPerMeasurement) {
+    return;
+  }
+  samples_since_measurement_ = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(imu_mutex_);
+    imu_snapshot_.clear();
+    for (size_t i = 0; i < imu_samples_.Size(); ++i) {
+      imu_snapshot_.push_back(imu_samples_[i]);
+    }
+  }
+  double offset_ns;
+  if (MeasureOffset(&offset_ns)) {
+    UpdateEstimate(timestamp_ns, offset_ns);
+  }
+}
+
+int64_t SixDoFTimeOffsetEstimator::ToImuTimestamp(
+    int64_t sixdof_timestamp_ns) const {
+  const Estimate estimate = published_estimate_.Load();
+  if (!estimate.is_valid) {
+    return sixdof_timestamp_ns;
+  }
+  const double elapsed_ns = static_cast<double>(
+      sixdof_timestamp_ns - estimate.reference_timestamp_ns);
+  return sixdof_timestamp_ns +
+         std::llround(estimate.offset_ns + estimate.drift * elapsed_ns);
+}
+
+SixDoFTimeOffsetEstimator::Estimate SixDoFTimeOffsetEstimator::GetEstimate()
+    const {
+  return published_estimate_.Load();
+}
+
+double SixDoFTimeOffsetEstimator::ComputeCorrelation(int64_t offset_ns,
+                                                     size_t begin,
+                                                     size_t end) const {
+  double sum_a = 0;
+  double sum_b = 0;
+  double sum_aa = 0;
+  double sum_bb = 0;
+  double sum_ab = 0;
+  // The 6DoF timestamps increase, so the IMU samples surrounding them are
+  // found by walking forward.
+  size_t next = 1;
+  for (size_t i = begin; i < end; ++i) {
+    const int64_t timestamp_ns = sixdof_samples_[i].timestamp_ns + offset_ns;
+    while (imu_snapshot_[next].timestamp_ns < timestamp_ns) {
+      ++next;
+    }
+    const Sample& previous = imu_snapshot_[next - 1];
+    const Sample& following = imu_snapshot_[next];
+    const double t =
+        static_cast<double>(timestamp_ns - previous.timestamp_ns) /
+        static_cast<double>(following.timestamp_ns - previous.timestamp_ns);
+    const double a = sixdof_samples_[i].angular_speed;
+    const double b = previous.angular_speed +
+                     t * (following.angular_speed - previous.angular_speed);
+    sum_a += a;
+    sum_b += b;
+    sum_aa += a * a;
+    sum_bb += b * b;
+    sum_ab += a * b;
+  }
+  const double n = static_cast<double>(end - begin);
+  const double variance_a = n * sum_aa - sum_a * sum_a;
+  const double variance_b = n * sum_bb - sum_b * sum_b;
+  if (variance_a <= 0 || variance_b <= 0) {
+    return 0;
+  }
+  return (n * sum_ab - sum_a * sum_b) / std::sqrt(variance_a * variance_b);
+}
+
+bool SixDoFTimeOffsetEstimator::MeasureOffset(double* offset_ns) const {
+  if (imu_snapshot_.size() < 2) {
+    return false;
+  }
+  // Only correlates the 6DoF samples for which every searched offset falls
+  // inside the IMU history, so that all offsets are scored on the same
+  // samples.
+  const int64_t first_imu_timestamp_ns = imu_snapshot_.front().timestamp_ns;
+  const int64_t last_imu_timestamp_ns = imu_snapshot_.back().timestamp_ns;
+  size_t begin = 0;
+  while (begin < sixdof_samples_.Size() &&
+         sixdof_samples_[begin].timestamp_ns - kMaximumOffsetNs <=
+             first_imu_timestamp_ns) {
+    ++begin;
+  }
+  size_t end = begin;
+  while (end < sixdof_samples_.Size() &&
+         sixdof_samples_[end].timestamp_ns + kMaximumOffsetNs <
+             last_imu_timestamp_ns) {
+    ++end;
+  }
+  if (end - begin < kMinimumCorrelatedSamples) {
+    return false;
+  }
+
+  double sum = 0;
+  double sum_of_squares = 0;
+  for (size_t i = begin; i < end; ++i) {
+    sum += sixdof_samples_[i].angular_speed;
+    sum_of_squares +=
+        sixdof_samples_[i].angular_speed * sixdof_samples_[i].angular_speed;
+  }
+  const double n = static_cast<double>(end - begin);
+  const double variance = sum_of_squares / n - (sum / n) * (sum / n);
+  if (variance < kMinimumAngularSpeedStdDev * kMinimumAngularSpeedStdDev) {
+    return false;
+  }
+
+  int64_t coarse_peak_ns = 0;
+  double coarse_peak = -1;
+  for (int64_t offset = -kMaximumOffsetNs; offset <= kMaximumOffsetNs;
+       offset += kCoarseStepNs) {
+    const double correlation = ComputeCorrelation(offset, begin, end);
+    if (correlation > coarse_peak) {
+      coarse_peak = correlation;
+      coarse_peak_ns = offset;
+    }
+  }
+  if (coarse_peak_ns == -kMaximumOffsetNs ||
+      coarse_peak_ns == kMaximumOffsetNs) {
+    return false;
+  }
+
+  constexpr int kFineSteps = kCoarseStepNs / kFineStepNs;
+  double correlations[2 * kFineSteps + 1];
+  int peak = 0;
+  for (int step = -kFineSteps; step <= kFineSteps; ++step) {
+    correlations[step + kFineSteps] =
+        ComputeCorrelation(coarse_peak_ns + step * kFineStepNs, begin, end);
+    if (correlations[step + kFineSteps] > correlations[peak]) {
+      peak = step + kFineSteps;
+    }
+  }
+  if (peak == 0 || peak == 2 * kFineSteps ||
+      correlations[peak] < kMinimumCorrelation) {
+    return false;
+  }
+
+  // Refines the peak with the vertex of the parabola through its neighbors.
+  const double left = correlations[peak - 1];
+  const double center = correlations[peak];
+  const double right = correlations[peak + 1];
+  const double curvature = left - 2 * center + right;
+  const double vertex =
+      curvature < 0 ? 0.5 * (left - right) / curvature : 0;
+  *offset_ns = static_cast<double>(coarse_peak_ns) +
+               (peak - kFineSteps + vertex) * static_cast<double>(kFineStepNs);
+  return true;
+}
+
+void SixDoFTimeOffsetEstimator::UpdateEstimate(int64_t timestamp_ns,
+                                               double offset_ns) {
+  const double measurement_variance =
+      kMeasurementStdDevNs * kMeasurementStdDevNs;
+  if (estimate_.is_valid) {
+    // Prediction.
+    const double elapsed_ns =
+        static_cast<double>(timestamp_ns - estimate_.reference_timestamp_ns);
+    const double elapsed_s = elapsed_ns * kNanosToSeconds;
+    estimate_.offset_ns += estimate_.drift * elapsed_ns;
+    estimate_.reference_timestamp_ns = timestamp_ns;
+    covariance_[0][0] += elapsed_ns * (covariance_[0][1] + covariance_[1][0]) +
+                         elapsed_ns * elapsed_ns * covariance_[1][1] +
+                         kOffsetRandomWalk * kOffsetRandomWalk * elapsed_s;
+    covariance_[0][1] += elapsed_ns * covariance_[1][1];
+    covariance_[1][0] = covariance_[0][1];
+    covariance_[1][1] += kDriftRandomWalk * kDriftRandomWalk * elapsed_s;
+
+    // Update.
+    const double innovation = offset_ns - estimate_.offset_ns;
+    const double innovation_variance =
+        covariance_[0][0] + measurement_variance;
+    if (innovation * innovation <=
+        kOutlierThreshold * kOutlierThreshold * innovation_variance) {
+      rejected_measurements_ = 0;
+      const double gain_offset = covariance_[0][0] / innovation_variance;
+      const double gain_drift = covariance_[1][0] / innovation_variance;
+      estimate_.offset_ns += gain_offset * innovation;
+      estimate_.drift += gain_drift * innovation;
+      covariance_[1][1] -= gain_drift * covariance_[0][1];
+      covariance_[0][1] -= gain_offset * covariance_[0][1];
+      covariance_[0][0] -= gain_offset * covariance_[0][0];
+      covariance_[1][0] = covariance_[0][1];
+      estimate_.offset_stddev_ns = std::sqrt(covariance_[0][0]);
+      published_estimate_.Store(estimate_);
+      return;
+    }
+    if (++rejected_measurements_ < kMaximumRejectedMeasurements) {
+      estimate_.offset_stddev_ns = std::sqrt(covariance_[0][0]);
+      published_estimate_.Store(estimate_);
+      return;
+    }
+  }
+
+  rejected_measurements_ = 0;
+  estimate_ = {offset_ns, 0, kMeasurementStdDevNs, timestamp_ns, true};
+  covariance_[0][0] = measurement_variance;
+  covariance_[0][1] = covariance_[1][0] = 0;
+  covariance_[1][1] = kInitialDriftStdDev * kInitialDriftStdDev;
+  published_estimate_.Store(estimate_);
+}
+
+}  // namespace cardboard
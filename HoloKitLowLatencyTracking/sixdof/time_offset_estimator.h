@@ -0,0 +1,130 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_SIXDOF_TIME_OFFSET_ESTIMATOR_H_
+#define CARDBOARD_SDK_SIXDOF_TIME_OFFSET_ESTIMATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "util/ring_buffer.h"
+#include "util/rotation.h"
+#include "util/seqlock.h"
+
+namespace cardboard {
+
+// Aryzon 6DoF
+//
+// Estimates the offset between the timestamps of the 6DoF poses and the clock
+// of the IMU, including the latency with which the 6DoF timestamps are
+// stamped, and the drift of that offset.
+//
+// The angular speed derived from consecutive 6DoF orientations is
+// cross-correlated with the angular speed of the EKF over the last two
+// seconds. Angular speeds are compared rather than angular velocities because
+// they do not depend on the rotation between the IMU and the 6DoF frames. The
+// peak of the normalized cross-correlation is a measurement of the offset,
+// which a two-state Kalman filter tracks together with its drift.
+// Measurements are only taken while the head moves enough for the peak to be
+// well defined; when still, the last estimate is kept.
+//
+// AddAngularSpeed() is called from the sensor thread, AddSixDoFOrientation()
+// from the thread delivering the 6DoF poses, and ToImuTimestamp() and
+// GetEstimate() from any thread.
+class SixDoFTimeOffsetEstimator {
+ public:
+  struct Estimate {
+    // Offset in nanoseconds to add to a 6DoF timestamp to express it in the
+    // IMU clock, at reference_timestamp_ns.
+    double offset_ns;
+    // Drift of the offset, in nanoseconds per nanosecond.
+    double drift;
+    // Standard deviation of offset_ns.
+    double offset_stddev_ns;
+    // 6DoF timestamp at which offset_ns was estimated.
+    int64_t reference_timestamp_ns;
+    // False until the first offset measurement.
+    bool is_valid;
+  };
+
+  SixDoFTimeOffsetEstimator();
+
+  // Discards all samples and the estimate.
+  void Reset();
+
+  // Adds the EKF angular speed at @p timestamp_ns, in the IMU clock.
+  //
+  // @param timestamp_ns timestamp of the EKF state.
+  // @param angular_speed norm of the bias-corrected angular velocity in
+  //        rad/s.
+  void AddAngularSpeed(int64_t timestamp_ns, double angular_speed);
+
+  // Adds a 6DoF orientation and, every few samples, measures the offset.
+  //
+  // @param timestamp_ns 6DoF timestamp of the pose.
+  // @param orientation 6DoF orientation.
+  void AddSixDoFOrientation(int64_t timestamp_ns, const Rotation& orientation);
+
+  // Returns @p sixdof_timestamp_ns expressed in the IMU clock. It is returned
+  // unchanged until an offset has been measured.
+  int64_t ToImuTimestamp(int64_t sixdof_timestamp_ns) const;
+
+  // Returns the current estimate.
+  Estimate GetEstimate() const;
+
+ private:
+  struct Sample {
+    int64_t timestamp_ns;
+    double angular_speed;
+  };
+
+  // Returns the normalized cross-correlation of the 6DoF angular speeds in
+  // [@p begin, @p end) with the IMU angular speeds @p offset_ns later.
+  double ComputeCorrelation(int64_t offset_ns, size_t begin, size_t end) const;
+
+  // Measures the offset from the buffered samples. Returns false if the
+  // motion does not define it well enough.
+  bool MeasureOffset(double* offset_ns) const;
+
+  // Updates the Kalman filter with an offset measured at @p timestamp_ns.
+  void UpdateEstimate(int64_t timestamp_ns, double offset_ns);
+
+  // EKF angular speeds. Guarded by imu_mutex_.
+  RingBuffer<Sample> imu_samples_;
+  std::mutex imu_mutex_;
+  // Copy of imu_samples_ taken for a measurement, kept to avoid allocating.
+  std::vector<Sample> imu_snapshot_;
+
+  // Angular speeds between consecutive 6DoF orientations, stamped at the
+  // middle of the two poses.
+  RingBuffer<Sample> sixdof_samples_;
+  Rotation previous_orientation_;
+  int64_t previous_timestamp_ns_;
+  int samples_since_measurement_;
+
+  // Kalman filter state: offset and drift at estimate_.reference_timestamp_ns
+  // and their covariance.
+  Estimate estimate_;
+  double covariance_[2][2];
+  int rejected_measurements_;
+
+  SeqLock<Estimate> published_estimate_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_SIXDOF_TIME_OFFSET_ESTIMATOR_H_
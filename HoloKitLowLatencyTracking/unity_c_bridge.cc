@@ -1,5 +1,14 @@
 #include "cardboard_input_api.h"
-#include <array>
+
+namespace {
+
+// Converts a pose from Cardboard space to Unity space in place.
+void ConvertPoseToUnitySpace(float *position, float *orientation) {
+    position[2] = -position[2];
+    orientation[2] = -orientation[2];
+}
+
+} // namespace
 
 extern "C" {
 
@@ -30,18 +39,45 @@ void HoloInteractiveHoloKit_LowLatencyTracking_addSixDoFData(void *self, int64_t
 
 void HoloInteractiveHoloKit_LowLatencyTracking_getHeadTrackerPose(void *self, float *position, float *orientation) {
     cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
-    
-    std::array<float, 3> out_position;
-    std::array<float, 4> out_orientation;
-    cardboard_input_api->GetHeadTrackerPose(out_position.data(), out_orientation.data());
-    
-    position[0] = out_position.at(0);
-    position[1] = out_position.at(1);
-    position[2] = -out_position.at(2);
-    orientation[0] = out_orientation.at(0);
-    orientation[1] = out_orientation.at(1);
-    orientation[2] = -out_orientation.at(2);
-    orientation[3] = out_orientation.at(3);
+    cardboard_input_api->GetHeadTrackerPose(position, orientation);
+    ConvertPoseToUnitySpace(position, orientation);
+}
+
+void HoloInteractiveHoloKit_LowLatencyTracking_getHeadTrackerPoseAtTime(void *self, int64_t target_display_time_ns, float *position, float *orientation) {
+    cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
+    cardboard_input_api->GetHeadTrackerPoseAtTime(target_display_time_ns, position, orientation);
+    ConvertPoseToUnitySpace(position, orientation);
+}
+
+void HoloInteractiveHoloKit_LowLatencyTracking_getHeadTrackerPoseForVsync(void *self, int64_t vsync_time_ns, int64_t refresh_period_ns, int pipeline_depth, float *position, float *orientation) {
+    cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
+    cardboard_input_api->GetHeadTrackerPoseForVsync(vsync_time_ns, refresh_period_ns, pipeline_depth, position, orientation);
+    ConvertPoseToUnitySpace(position, orientation);
+}
+
+void HoloInteractiveHoloKit_LowLatencyTracking_setPredictionTime(void *self, int64_t prediction_time_ns) {
+    cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
+    cardboard_input_api->SetPredictionTime(prediction_time_ns);
+}
+
+void HoloInteractiveHoloKit_LowLatencyTracking_setRotationPredictionModel(void *self, int model) {
+    cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
+    cardboard_input_api->SetRotationPredictionModel(static_cast<CardboardRotationPredictionModel>(model));
+}
+
+void HoloInteractiveHoloKit_LowLatencyTracking_setGyroscopeBiasEstimation(void *self, int estimation) {
+    cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
+    cardboard_input_api->SetGyroscopeBiasEstimation(static_cast<CardboardGyroscopeBiasEstimation>(estimation));
+}
+
+void HoloInteractiveHoloKit_LowLatencyTracking_setPositionPredictionModel(void *self, int model) {
+    cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
+    cardboard_input_api->SetPositionPredictionModel(static_cast<CardboardPositionPredictionModel>(model));
+}
+
+bool HoloInteractiveHoloKit_LowLatencyTracking_getSixDoFTimeOffset(void *self, int64_t *offset_ns, int64_t *offset_stddev_ns, float *drift_ppm) {
+    cardboard::unity::CardboardInputApi *cardboard_input_api = static_cast<cardboard::unity::CardboardInputApi *>(self);
+    return cardboard_input_api->GetSixDoFTimeOffset(offset_ns, offset_stddev_ns, drift_ppm);
 }
 
 void HoloInteractiveHoloKit_LowLatencyTracking_delete(void *self) {
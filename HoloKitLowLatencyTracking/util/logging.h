@@ -42,8 +42,10 @@
 
 #include <stdio.h>
 
-#define CARDBOARD_LOGI(...) fprintf(stdout, __VA_ARGS__)
-#define CARDBOARD_LOGD(...) fprintf(stdout, __VA_ARGS__)
+// Host builds log everything to stderr so that stdout stays usable for tool
+// output (e.g. poses printed by the trace replay tool).
+#define CARDBOARD_LOGI(...) fprintf(stderr, __VA_ARGS__)
+#define CARDBOARD_LOGD(...) fprintf(stderr, __VA_ARGS__)
 #define CARDBOARD_LOGE(...) fprintf(stderr, __VA_ARGS__)
 #define CARDBOARD_LOGF(...) fprintf(stderr, __VA_ARGS__)
 
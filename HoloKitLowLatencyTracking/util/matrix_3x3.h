@@ -21,92 +21,170 @@
 #include <istream>  // NOLINT
 #include <ostream>  // NOLINT
 
+#include "util/simd.h"
+
 namespace cardboard {
 
-// The Matrix3x3 class defines a square 3-dimensional matrix. Elements are
-// stored in row-major order.
+// The BasicMatrix3x3 class defines a square 3-dimensional matrix of Scalar
+// elements. Elements are stored in row-major order. Use the Matrix3x3
+// (double) and Matrix3x3f (float) typedefs.
+//
+// The arithmetic is defined inline so that chains such as
+// P * Transpose(H) * Inverse(S) or (I - K * H) * P compile into unrolled
+// straight-line code without calls and with the intermediate results kept in
+// registers.
 // TODO(b/135461889): Make this class consistent with Matrix4x4.
-class Matrix3x3 {
+template <typename Scalar>
+class BasicMatrix3x3 {
  public:
   // The default constructor zero-initializes all elements.
-  Matrix3x3();
+  BasicMatrix3x3() : elem_{} {}
 
   // Dimension-specific constructors that are passed individual element values.
-  Matrix3x3(double m00, double m01, double m02, double m10, double m11,
-            double m12, double m20, double m21, double m22);
+  BasicMatrix3x3(Scalar m00, Scalar m01, Scalar m02, Scalar m10, Scalar m11,
+                 Scalar m12, Scalar m20, Scalar m21, Scalar m22)
+      : elem_{{{m00, m01, m02}, {m10, m11, m12}, {m20, m21, m22}}} {}
 
   // Constructor that reads elements from a linear array of the correct size.
-  explicit Matrix3x3(const double array[3 * 3]);
+  explicit BasicMatrix3x3(const Scalar array[3 * 3]);
+
+  // Converts a matrix of another scalar type.
+  template <typename OtherScalar>
+  explicit BasicMatrix3x3(const BasicMatrix3x3<OtherScalar>& m) {
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col) {
+        elem_[row][col] = static_cast<Scalar>(m(row, col));
+      }
+    }
+  }
 
   // Returns a Matrix3x3 containing all zeroes.
-  static Matrix3x3 Zero();
+  static BasicMatrix3x3 Zero() { return BasicMatrix3x3(); }
 
   // Returns an identity Matrix3x3.
-  static Matrix3x3 Identity();
+  static BasicMatrix3x3 Identity() {
+    return BasicMatrix3x3(1, 0, 0, 0, 1, 0, 0, 0, 1);
+  }
 
   // Mutable element accessors.
-  double& operator()(int row, int col) { return elem_[row][col]; }
-  std::array<double, 3>& operator[](int row) { return elem_[row]; }
+  Scalar& operator()(int row, int col) { return elem_[row][col]; }
+  std::array<Scalar, 3>& operator[](int row) { return elem_[row]; }
 
   // Read-only element accessors.
-  const double& operator()(int row, int col) const { return elem_[row][col]; }
-  const std::array<double, 3>& operator[](int row) const { return elem_[row]; }
+  const Scalar& operator()(int row, int col) const { return elem_[row][col]; }
+  const std::array<Scalar, 3>& operator[](int row) const { return elem_[row]; }
 
   // Return a pointer to the data for interfacing with libraries.
-  double* Data() { return &elem_[0][0]; }
-  const double* Data() const { return &elem_[0][0]; }
+  Scalar* Data() { return &elem_[0][0]; }
+  const Scalar* Data() const { return &elem_[0][0]; }
 
   // Self-modifying multiplication operators.
-  void operator*=(double s) { MultiplyScalar(s); }
-  void operator*=(const Matrix3x3& m) { *this = Product(*this, m); }
+  void operator*=(Scalar s) { MultiplyScalar(s); }
+  void operator*=(const BasicMatrix3x3& m) { *this = Product(*this, m); }
 
   // Unary operators.
-  Matrix3x3 operator-() const { return Negation(); }
+  BasicMatrix3x3 operator-() const { return Negation(); }
 
   // Binary scale operators.
-  friend Matrix3x3 operator*(const Matrix3x3& m, double s) {
+  friend BasicMatrix3x3 operator*(const BasicMatrix3x3& m, Scalar s) {
     return Scale(m, s);
   }
-  friend Matrix3x3 operator*(double s, const Matrix3x3& m) {
+  friend BasicMatrix3x3 operator*(Scalar s, const BasicMatrix3x3& m) {
     return Scale(m, s);
   }
 
   // Binary matrix addition.
-  friend Matrix3x3 operator+(const Matrix3x3& lhs, const Matrix3x3& rhs) {
+  friend BasicMatrix3x3 operator+(const BasicMatrix3x3& lhs,
+                                  const BasicMatrix3x3& rhs) {
     return Addition(lhs, rhs);
   }
 
   // Binary matrix subtraction.
-  friend Matrix3x3 operator-(const Matrix3x3& lhs, const Matrix3x3& rhs) {
+  friend BasicMatrix3x3 operator-(const BasicMatrix3x3& lhs,
+                                  const BasicMatrix3x3& rhs) {
     return Subtraction(lhs, rhs);
   }
 
   // Binary multiplication operator.
-  friend Matrix3x3 operator*(const Matrix3x3& m0, const Matrix3x3& m1) {
+  friend BasicMatrix3x3 operator*(const BasicMatrix3x3& m0,
+                                  const BasicMatrix3x3& m1) {
     return Product(m0, m1);
   }
 
   // Exact equality and inequality comparisons.
-  friend bool operator==(const Matrix3x3& m0, const Matrix3x3& m1) {
+  friend bool operator==(const BasicMatrix3x3& m0, const BasicMatrix3x3& m1) {
     return AreEqual(m0, m1);
   }
-  friend bool operator!=(const Matrix3x3& m0, const Matrix3x3& m1) {
+  friend bool operator!=(const BasicMatrix3x3& m0, const BasicMatrix3x3& m1) {
     return !AreEqual(m0, m1);
   }
 
  private:
   // These private functions implement most of the operators.
-  void MultiplyScalar(double s);
-  Matrix3x3 Negation() const;
-  static Matrix3x3 Addition(const Matrix3x3& lhs, const Matrix3x3& rhs);
-  static Matrix3x3 Subtraction(const Matrix3x3& lhs, const Matrix3x3& rhs);
-  static Matrix3x3 Scale(const Matrix3x3& m, double s);
-  static Matrix3x3 Product(const Matrix3x3& m0, const Matrix3x3& m1);
-  static bool AreEqual(const Matrix3x3& m0, const Matrix3x3& m1);
-
-  std::array<std::array<double, 3>, 3> elem_;
+  void MultiplyScalar(Scalar s) {
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col) elem_[row][col] *= s;
+    }
+  }
+
+  BasicMatrix3x3 Negation() const {
+    BasicMatrix3x3 result;
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col)
+        result.elem_[row][col] = -elem_[row][col];
+    }
+    return result;
+  }
+
+  static BasicMatrix3x3 Addition(const BasicMatrix3x3& lhs,
+                                 const BasicMatrix3x3& rhs) {
+    BasicMatrix3x3 result;
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col)
+        result.elem_[row][col] = lhs.elem_[row][col] + rhs.elem_[row][col];
+    }
+    return result;
+  }
+
+  static BasicMatrix3x3 Subtraction(const BasicMatrix3x3& lhs,
+                                    const BasicMatrix3x3& rhs) {
+    BasicMatrix3x3 result;
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col)
+        result.elem_[row][col] = lhs.elem_[row][col] - rhs.elem_[row][col];
+    }
+    return result;
+  }
+
+  static BasicMatrix3x3 Scale(const BasicMatrix3x3& m, Scalar s) {
+    BasicMatrix3x3 result;
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col)
+        result.elem_[row][col] = m.elem_[row][col] * s;
+    }
+    return result;
+  }
+
+  static BasicMatrix3x3 Product(const BasicMatrix3x3& m0,
+                                const BasicMatrix3x3& m1) {
+    BasicMatrix3x3 result;
+    simd::Matrix3x3Multiply(m0.Data(), m1.Data(), result.Data());
+    return result;
+  }
+
+  static bool AreEqual(const BasicMatrix3x3& m0, const BasicMatrix3x3& m1) {
+    return m0.elem_ == m1.elem_;
+  }
+
+  std::array<std::array<Scalar, 3>, 3> elem_;
 };
 
+typedef BasicMatrix3x3<double> Matrix3x3;
+typedef BasicMatrix3x3<float> Matrix3x3f;
+
+extern template class BasicMatrix3x3<double>;
+extern template class BasicMatrix3x3<float>;
+
 }  // namespace cardboard
 
 #endif  // CARDBOARD_SDK_UTIL_MATRIX_3X3_H_
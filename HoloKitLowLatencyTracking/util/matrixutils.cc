@@ -15,6 +15,8 @@
  */
 #include "util/matrixutils.h"
 
+#include <algorithm>
+
 #include "util/vectorutils.h"
 
 namespace cardboard {
@@ -27,28 +29,21 @@ static bool IsCofactorNegated(int row, int col) {
   return ((row + col) & 1) != 0;
 }
 
-static double CofactorElement3(const Matrix3x3& m, int row, int col) {
+template <typename Scalar>
+Scalar CofactorElement3(const BasicMatrix3x3<Scalar>& m, int row, int col) {
   static const int index[3][2] = {{1, 2}, {0, 2}, {0, 1}};
   const int i0 = index[row][0];
   const int i1 = index[row][1];
   const int j0 = index[col][0];
   const int j1 = index[col][1];
-  const double cofactor = m(i0, j0) * m(i1, j1) - m(i0, j1) * m(i1, j0);
+  const Scalar cofactor = m(i0, j0) * m(i1, j1) - m(i0, j1) * m(i1, j0);
   return IsCofactorNegated(row, col) ? -cofactor : cofactor;
 }
 
-// Multiplies a matrix and some type of column vector to
-// produce another column vector of the same type.
-Vector3 MultiplyMatrixAndVector(const Matrix3x3& m, const Vector3& v) {
-  Vector3 result = Vector3::Zero();
-  for (int row = 0; row < 3; ++row) {
-    for (int col = 0; col < 3; ++col) result[row] += m(row, col) * v[col];
-  }
-  return result;
-}
-
 // Sets the upper 3x3 of a Matrix to represent a 3D rotation.
-void RotationMatrix3x3(const Rotation& r, Matrix3x3* matrix) {
+template <typename Scalar>
+void RotationMatrix3x3(const BasicRotation<Scalar>& r,
+                       BasicMatrix3x3<Scalar>* matrix) {
   //
   // Given a quaternion (a,b,c,d) where d is the scalar part, the 3x3 rotation
   // matrix is:
@@ -57,21 +52,21 @@ void RotationMatrix3x3(const Rotation& r, Matrix3x3* matrix) {
   //         2ab + 2cd        -a^2 + b^2 - c^2 + d^2         2bc - 2ad
   //         2ac - 2bd               2bc + 2ad        -a^2 - b^2 + c^2 + d^2
   //
-  const Vector<4>& quat = r.GetQuaternion();
-  const double aa = quat[0] * quat[0];
-  const double bb = quat[1] * quat[1];
-  const double cc = quat[2] * quat[2];
-  const double dd = quat[3] * quat[3];
+  const Vector<4, Scalar>& quat = r.GetQuaternion();
+  const Scalar aa = quat[0] * quat[0];
+  const Scalar bb = quat[1] * quat[1];
+  const Scalar cc = quat[2] * quat[2];
+  const Scalar dd = quat[3] * quat[3];
 
-  const double ab = quat[0] * quat[1];
-  const double ac = quat[0] * quat[2];
-  const double bc = quat[1] * quat[2];
+  const Scalar ab = quat[0] * quat[1];
+  const Scalar ac = quat[0] * quat[2];
+  const Scalar bc = quat[1] * quat[2];
 
-  const double ad = quat[0] * quat[3];
-  const double bd = quat[1] * quat[3];
-  const double cd = quat[2] * quat[3];
+  const Scalar ad = quat[0] * quat[3];
+  const Scalar bd = quat[1] * quat[3];
+  const Scalar cd = quat[2] * quat[3];
 
-  Matrix3x3& m = *matrix;
+  BasicMatrix3x3<Scalar>& m = *matrix;
   m[0][0] = aa - bb - cc + dd;
   m[0][1] = 2 * ab - 2 * cd;
   m[0][2] = 2 * ac + 2 * bd;
@@ -85,12 +80,9 @@ void RotationMatrix3x3(const Rotation& r, Matrix3x3* matrix) {
 
 }  // anonymous namespace
 
-Vector3 operator*(const Matrix3x3& m, const Vector3& v) {
-  return MultiplyMatrixAndVector(m, v);
-}
-
-Matrix3x3 CofactorMatrix(const Matrix3x3& m) {
-  Matrix3x3 result;
+template <typename Scalar>
+BasicMatrix3x3<Scalar> CofactorMatrix(const BasicMatrix3x3<Scalar>& m) {
+  BasicMatrix3x3<Scalar> result;
   for (int row = 0; row < 3; ++row) {
     for (int col = 0; col < 3; ++col)
       result(row, col) = CofactorElement3(m, row, col);
@@ -98,8 +90,10 @@ Matrix3x3 CofactorMatrix(const Matrix3x3& m) {
   return result;
 }
 
-Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, double* determinant) {
-  const Matrix3x3 cofactor_matrix = CofactorMatrix(m);
+template <typename Scalar>
+BasicMatrix3x3<Scalar> AdjugateWithDeterminant(const BasicMatrix3x3<Scalar>& m,
+                                               Scalar* determinant) {
+  const BasicMatrix3x3<Scalar> cofactor_matrix = CofactorMatrix(m);
   if (determinant) {
     *determinant = m(0, 0) * cofactor_matrix(0, 0) +
                    m(0, 1) * cofactor_matrix(0, 1) +
@@ -108,34 +102,88 @@ Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, double* determinant) {
   return Transpose(cofactor_matrix);
 }
 
-// Returns the transpose of a matrix.
-Matrix3x3 Transpose(const Matrix3x3& m) {
-  Matrix3x3 result;
-  for (int row = 0; row < 3; ++row) {
-    for (int col = 0; col < 3; ++col) result(row, col) = m(col, row);
-  }
-  return result;
-}
-
-Matrix3x3 InverseWithDeterminant(const Matrix3x3& m, double* determinant) {
+template <typename Scalar>
+BasicMatrix3x3<Scalar> InverseWithDeterminant(const BasicMatrix3x3<Scalar>& m,
+                                              Scalar* determinant) {
   // The inverse is the adjugate divided by the determinant.
-  double det;
-  Matrix3x3 adjugate = AdjugateWithDeterminant(m, &det);
+  Scalar det;
+  BasicMatrix3x3<Scalar> adjugate = AdjugateWithDeterminant(m, &det);
   if (determinant) *determinant = det;
   if (det == 0)
-    return Matrix3x3::Zero();
+    return BasicMatrix3x3<Scalar>::Zero();
   else
-    return adjugate * (1.0 / det);
+    return adjugate * (Scalar(1) / det);
 }
 
-Matrix3x3 Inverse(const Matrix3x3& m) {
-  return InverseWithDeterminant(m, nullptr);
+template <typename Scalar>
+BasicMatrix3x3<Scalar> Inverse(const BasicMatrix3x3<Scalar>& m) {
+  return InverseWithDeterminant(m, static_cast<Scalar*>(nullptr));
 }
 
-Matrix3x3 RotationMatrixNH(const Rotation& r) {
-  Matrix3x3 m;
+template <typename Scalar>
+BasicMatrix3x3<Scalar> RotationMatrixNH(const BasicRotation<Scalar>& r) {
+  BasicMatrix3x3<Scalar> m;
   RotationMatrix3x3(r, &m);
   return m;
 }
 
+template <typename Scalar>
+bool SolveSymmetricPositiveDefinite(const BasicSymmetricMatrix3x3<Scalar>& s,
+                                    const BasicMatrix3x3<Scalar>& b,
+                                    Scalar min_pivot_ratio,
+                                    BasicMatrix3x3<Scalar>* x) {
+  // s = L * D * L' with L unit lower triangular and D diagonal.
+  const Scalar min_pivot =
+      min_pivot_ratio * std::max({s(0, 0), s(1, 1), s(2, 2)});
+  const Scalar d0 = s(0, 0);
+  if (!(d0 > min_pivot)) {
+    return false;
+  }
+  const Scalar l10 = s(1, 0) / d0;
+  const Scalar l20 = s(2, 0) / d0;
+  const Scalar d1 = s(1, 1) - l10 * l10 * d0;
+  if (!(d1 > min_pivot)) {
+    return false;
+  }
+  const Scalar l21 = (s(2, 1) - l20 * l10 * d0) / d1;
+  const Scalar d2 = s(2, 2) - l20 * l20 * d0 - l21 * l21 * d1;
+  if (!(d2 > min_pivot)) {
+    return false;
+  }
+
+  // Since s is symmetric, each row of x solves s * x_row' = b_row'.
+  for (int row = 0; row < 3; ++row) {
+    // Forward substitution with L, then scaling by D^-1.
+    const Scalar y0 = b(row, 0);
+    const Scalar y1 = b(row, 1) - l10 * y0;
+    const Scalar y2 = b(row, 2) - l20 * y0 - l21 * y1;
+    // Back substitution with L'.
+    const Scalar x2 = y2 / d2;
+    const Scalar x1 = y1 / d1 - l21 * x2;
+    const Scalar x0 = y0 / d0 - l10 * x1 - l20 * x2;
+    (*x)(row, 0) = x0;
+    (*x)(row, 1) = x1;
+    (*x)(row, 2) = x2;
+  }
+  return true;
+}
+
+#define CARDBOARD_SDK_INSTANTIATE_MATRIXUTILS(Scalar)                         \
+  template BasicMatrix3x3<Scalar> AdjugateWithDeterminant(                    \
+      const BasicMatrix3x3<Scalar>& m, Scalar* determinant);                  \
+  template BasicMatrix3x3<Scalar> InverseWithDeterminant(                     \
+      const BasicMatrix3x3<Scalar>& m, Scalar* determinant);                  \
+  template BasicMatrix3x3<Scalar> Inverse(const BasicMatrix3x3<Scalar>& m);   \
+  template BasicMatrix3x3<Scalar> RotationMatrixNH(                           \
+      const BasicRotation<Scalar>& r);                                        \
+  template bool SolveSymmetricPositiveDefinite(                               \
+      const BasicSymmetricMatrix3x3<Scalar>& s,                               \
+      const BasicMatrix3x3<Scalar>& b, Scalar min_pivot_ratio,                \
+      BasicMatrix3x3<Scalar>* x);
+
+CARDBOARD_SDK_INSTANTIATE_MATRIXUTILS(double)
+CARDBOARD_SDK_INSTANTIATE_MATRIXUTILS(float)
+
+#undef CARDBOARD_SDK_INSTANTIATE_MATRIXUTILS
+
 }  // namespace cardboard
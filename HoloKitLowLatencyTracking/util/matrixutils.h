@@ -18,47 +18,86 @@
 
 //
 // This file contains operators and free functions that define generic Matrix
-// operations.
+// operations. The templates are instantiated for double and float, except
+// for the small kernels defined inline below.
 //
 
 #include "util/matrix_3x3.h"
 #include "util/rotation.h"
+#include "util/symmetric_matrix_3x3.h"
 #include "util/vector.h"
 
 namespace cardboard {
 
 // Returns the transpose of a matrix.
-Matrix3x3 Transpose(const Matrix3x3& m);
+template <typename Scalar>
+inline BasicMatrix3x3<Scalar> Transpose(const BasicMatrix3x3<Scalar>& m) {
+  return BasicMatrix3x3<Scalar>(m(0, 0), m(1, 0), m(2, 0), m(0, 1), m(1, 1),
+                                m(2, 1), m(0, 2), m(1, 2), m(2, 2));
+}
 
 // Multiplies a Matrix and a column Vector of the same Dimension to produce
 // another column Vector.
-Vector3 operator*(const Matrix3x3& m, const Vector3& v);
+template <typename Scalar>
+inline Vector<3, Scalar> operator*(const BasicMatrix3x3<Scalar>& m,
+                                   const Vector<3, Scalar>& v) {
+  return Vector<3, Scalar>(m(0, 0) * v[0] + m(0, 1) * v[1] + m(0, 2) * v[2],
+                           m(1, 0) * v[0] + m(1, 1) * v[1] + m(1, 2) * v[2],
+                           m(2, 0) * v[0] + m(2, 1) * v[1] + m(2, 2) * v[2]);
+}
 
 // Returns the determinant of the matrix. This function is defined for all the
 // typedef'ed Matrix types.
-double Determinant(const Matrix3x3& m);
+template <typename Scalar>
+Scalar Determinant(const BasicMatrix3x3<Scalar>& m);
 
 // Returns the adjugate of the matrix, which is defined as the transpose of the
 // cofactor matrix. This function is defined for all the typedef'ed Matrix
 // types.  The determinant of the matrix is computed as a side effect, so it is
 // returned in the determinant parameter if it is not null.
-Matrix3x3 AdjugateWithDeterminant(const Matrix3x3& m, double* determinant);
+template <typename Scalar>
+BasicMatrix3x3<Scalar> AdjugateWithDeterminant(const BasicMatrix3x3<Scalar>& m,
+                                               Scalar* determinant);
 
 // Returns the inverse of the matrix. This function is defined for all the
 // typedef'ed Matrix types.  The determinant of the matrix is computed as a
 // side effect, so it is returned in the determinant parameter if it is not
 // null. If the determinant is 0, the returned matrix has all zeroes.
-Matrix3x3 InverseWithDeterminant(const Matrix3x3& m, double* determinant);
+template <typename Scalar>
+BasicMatrix3x3<Scalar> InverseWithDeterminant(const BasicMatrix3x3<Scalar>& m,
+                                              Scalar* determinant);
 
 // Returns the inverse of the matrix. This function is defined for all the
 // typedef'ed Matrix types. If the determinant of the matrix is 0, the returned
 // matrix has all zeroes.
-Matrix3x3 Inverse(const Matrix3x3& m);
+template <typename Scalar>
+BasicMatrix3x3<Scalar> Inverse(const BasicMatrix3x3<Scalar>& m);
 
 // Returns a 3x3 Matrix representing a 3D rotation. This creates a Matrix that
 // does not work with homogeneous coordinates, so the function name ends in
 // "NH".
-Matrix3x3 RotationMatrixNH(const Rotation& r);
+template <typename Scalar>
+BasicMatrix3x3<Scalar> RotationMatrixNH(const BasicRotation<Scalar>& r);
+
+// Solves x * s = b for x, where s is symmetric positive definite, using its
+// LDL' factorization. This is cheaper and more accurate than multiplying by
+// Inverse(s). Returns false and leaves @p x untouched if a pivot of the
+// factorization is not larger than @p min_pivot_ratio times the largest
+// diagonal element of s, i.e. if s is not positive definite or is too badly
+// conditioned for the result to be meaningful.
+template <typename Scalar>
+bool SolveSymmetricPositiveDefinite(const BasicSymmetricMatrix3x3<Scalar>& s,
+                                    const BasicMatrix3x3<Scalar>& b,
+                                    Scalar min_pivot_ratio,
+                                    BasicMatrix3x3<Scalar>* x);
+
+// Returns the cross product matrix of @p v, i.e. the skew-symmetric matrix
+// such that SkewSymmetric(v) * u == Cross(v, u).
+template <typename Scalar>
+inline BasicMatrix3x3<Scalar> SkewSymmetric(const Vector<3, Scalar>& v) {
+  return BasicMatrix3x3<Scalar>(0, -v[2], v[1], v[2], 0, -v[0], -v[1], v[0],
+                                0);
+}
 
 }  // namespace cardboard
 
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_RING_BUFFER_H_
+#define CARDBOARD_SDK_UTIL_RING_BUFFER_H_
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace cardboard {
+
+// Fixed-capacity FIFO that overwrites its oldest element once full.
+//
+// Storage is a single contiguous block allocated at construction, so pushing
+// and reading never allocate. Callers that keep a value together with its
+// timestamp should store both in one element type rather than keeping two
+// parallel buffers.
+template <typename T>
+class RingBuffer {
+ public:
+  // Creates an empty buffer holding at most @p capacity elements.
+  // @param capacity maximum number of elements, must be greater than zero.
+  explicit RingBuffer(size_t capacity)
+      : storage_(capacity), head_(0), size_(0) {}
+
+  // Appends @p value, dropping the oldest element if the buffer is full.
+  void Push(const T& value) {
+    const size_t capacity = storage_.size();
+    if (size_ < capacity) {
+      storage_[Wrap(head_ + size_)] = value;
+      ++size_;
+    } else {
+      storage_[head_] = value;
+      head_ = Wrap(head_ + 1);
+    }
+  }
+
+  // Inserts @p value before the element at @p index, dropping the oldest
+  // element if the buffer is full. @p index must not be greater than Size().
+  // The newer elements are moved, so that inserting near the back is cheap.
+  void Insert(size_t index, const T& value) {
+    assert(index <= size_);
+    if (size_ == storage_.size()) {
+      if (index == 0) {
+        // The value would be the oldest element, which is dropped.
+        return;
+      }
+      PopFront();
+      --index;
+    }
+    ++size_;
+    for (size_t i = size_ - 1; i > index; --i) {
+      (*this)[i] = (*this)[i - 1];
+    }
+    (*this)[index] = value;
+  }
+
+  // Removes the oldest element. The buffer must not be empty.
+  void PopFront() {
+    head_ = Wrap(head_ + 1);
+    --size_;
+  }
+
+  // Removes all elements. Does not release the storage.
+  void Clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  // Returns the element at @p index, 0 being the oldest and Size() - 1 the
+  // newest. @p index must be lower than Size().
+  const T& operator[](size_t index) const {
+    assert(index < size_);
+    return storage_[Wrap(head_ + index)];
+  }
+  T& operator[](size_t index) {
+    assert(index < size_);
+    return storage_[Wrap(head_ + index)];
+  }
+
+  // Returns the oldest element. The buffer must not be empty.
+  const T& Front() const { return storage_[head_]; }
+
+  // Returns the newest element. The buffer must not be empty.
+  const T& Back() const { return (*this)[size_ - 1]; }
+
+  size_t Size() const { return size_; }
+  size_t Capacity() const { return storage_.size(); }
+  bool IsEmpty() const { return size_ == 0; }
+  bool IsFull() const { return size_ == storage_.size(); }
+
+ private:
+  // Maps a position in [0, 2 * Capacity()) onto the storage, avoiding a
+  // division on the per-sample path.
+  size_t Wrap(size_t position) const {
+    return position >= storage_.size() ? position - storage_.size() : position;
+  }
+
+  std::vector<T> storage_;
+  // Index in storage_ of the oldest element.
+  size_t head_;
+  size_t size_;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_RING_BUFFER_H_
@@ -15,6 +15,7 @@
  */
 #include "util/rotation.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -22,127 +23,208 @@
 
 namespace cardboard {
 
-void Rotation::SetAxisAndAngle(const VectorType& axis, double angle) {
+namespace {
+
+// Below this angle, Exp() uses the Taylor expansions of sin(angle / 2) / angle
+// and cos(angle / 2) up to angle^6, which are exact to double precision.
+constexpr double kExpTaylorThreshold = 0.05;
+// Below this ratio x of the vector and scalar parts of the quaternion, Log()
+// uses the Taylor expansion of atan(x) / x up to x^6, which is exact to double
+// precision. This is about a 0.02 rad angle.
+constexpr double kLogTaylorThreshold = 0.01;
+
+}  // namespace
+
+template <typename Scalar>
+void BasicRotation<Scalar>::SetAxisAndAngle(const VectorType& axis,
+                                            Scalar angle) {
   VectorType unit_axis = axis;
   if (!Normalize(&unit_axis)) {
     *this = Identity();
   } else {
-    double a = angle / 2;
-    const double s = sin(a);
-    SetQuaternion(QuaternionType(unit_axis * s, cos(a)));
+    *this = Exp(unit_axis * angle);
+  }
+}
+
+template <typename Scalar>
+BasicRotation<Scalar> BasicRotation<Scalar>::Exp(const VectorType& v) {
+  const Scalar angle_squared = LengthSquared(v);
+  // sin(angle / 2) / angle and cos(angle / 2).
+  Scalar half_sine_over_angle;
+  Scalar half_cosine;
+  if (angle_squared < Scalar(kExpTaylorThreshold * kExpTaylorThreshold)) {
+    const Scalar a2 = angle_squared;
+    half_sine_over_angle =
+        Scalar(1.0 / 2) +
+        a2 * (Scalar(-1.0 / 48) +
+              a2 * (Scalar(1.0 / 3840) - a2 * Scalar(1.0 / 645120)));
+    half_cosine =
+        1 + a2 * (Scalar(-1.0 / 8) +
+                  a2 * (Scalar(1.0 / 384) - a2 * Scalar(1.0 / 46080)));
+  } else {
+    const Scalar angle = std::sqrt(angle_squared);
+    half_sine_over_angle = std::sin(angle / 2) / angle;
+    half_cosine = std::cos(angle / 2);
+  }
+  return BasicRotation(v[0] * half_sine_over_angle,
+                       v[1] * half_sine_over_angle,
+                       v[2] * half_sine_over_angle, half_cosine);
+}
+
+template <typename Scalar>
+typename BasicRotation<Scalar>::VectorType BasicRotation<Scalar>::Log() const {
+  // q and -q are the same rotation. Using the one with a non-negative scalar
+  // part gives the angle in [0, pi].
+  const Scalar sign = quat_[3] < 0 ? -1 : 1;
+  const Scalar w = sign * quat_[3];
+  const VectorType u(sign * quat_[0], sign * quat_[1], sign * quat_[2]);
+  const Scalar u_squared = LengthSquared(u);
+  // angle / |u|, with angle = 2 * atan(|u| / w).
+  Scalar scale;
+  if (u_squared < Scalar(kLogTaylorThreshold * kLogTaylorThreshold) * w * w) {
+    const Scalar x2 = u_squared / (w * w);
+    scale = 2 / w *
+            (1 + x2 * (Scalar(-1.0 / 3) +
+                       x2 * (Scalar(1.0 / 5) - x2 * Scalar(1.0 / 7))));
+  } else {
+    const Scalar u_norm = std::sqrt(u_squared);
+    if (u_norm == 0) {
+      // Only reached by a zero quaternion.
+      return VectorType::Zero();
+    }
+    scale = 2 * std::atan2(u_norm, w) / u_norm;
   }
+  return u * scale;
 }
 
-Rotation Rotation::FromRotationMatrix(const Matrix3x3& mat) {
-  static const double kOne = 1.0;
-  static const double kFour = 4.0;
+template <typename Scalar>
+BasicRotation<Scalar> BasicRotation<Scalar>::FromRotationMatrix(
+    const BasicMatrix3x3<Scalar>& mat) {
+  static const Scalar kOne = 1.0;
+  static const Scalar kFour = 4.0;
 
-  const double d0 = mat(0, 0), d1 = mat(1, 1), d2 = mat(2, 2);
-  const double ww = kOne + d0 + d1 + d2;
-  const double xx = kOne + d0 - d1 - d2;
-  const double yy = kOne - d0 + d1 - d2;
-  const double zz = kOne - d0 - d1 + d2;
+  const Scalar d0 = mat(0, 0), d1 = mat(1, 1), d2 = mat(2, 2);
+  const Scalar ww = kOne + d0 + d1 + d2;
+  const Scalar xx = kOne + d0 - d1 - d2;
+  const Scalar yy = kOne - d0 + d1 - d2;
+  const Scalar zz = kOne - d0 - d1 + d2;
 
-  const double max = std::max(ww, std::max(xx, std::max(yy, zz)));
+  const Scalar max = std::max(ww, std::max(xx, std::max(yy, zz)));
   if (ww == max) {
-    const double w4 = sqrt(ww * kFour);
-    return Rotation::FromQuaternion(QuaternionType(
+    const Scalar w4 = std::sqrt(ww * kFour);
+    return FromQuaternion(QuaternionType(
         (mat(2, 1) - mat(1, 2)) / w4, (mat(0, 2) - mat(2, 0)) / w4,
         (mat(1, 0) - mat(0, 1)) / w4, w4 / kFour));
   }
 
   if (xx == max) {
-    const double x4 = sqrt(xx * kFour);
-    return Rotation::FromQuaternion(QuaternionType(
+    const Scalar x4 = std::sqrt(xx * kFour);
+    return FromQuaternion(QuaternionType(
         x4 / kFour, (mat(0, 1) + mat(1, 0)) / x4, (mat(0, 2) + mat(2, 0)) / x4,
         (mat(2, 1) - mat(1, 2)) / x4));
   }
 
   if (yy == max) {
-    const double y4 = sqrt(yy * kFour);
-    return Rotation::FromQuaternion(QuaternionType(
+    const Scalar y4 = std::sqrt(yy * kFour);
+    return FromQuaternion(QuaternionType(
         (mat(0, 1) + mat(1, 0)) / y4, y4 / kFour, (mat(1, 2) + mat(2, 1)) / y4,
         (mat(0, 2) - mat(2, 0)) / y4));
   }
 
   // zz is the largest component.
-  const double z4 = sqrt(zz * kFour);
-  return Rotation::FromQuaternion(
+  const Scalar z4 = std::sqrt(zz * kFour);
+  return FromQuaternion(
       QuaternionType((mat(0, 2) + mat(2, 0)) / z4, (mat(1, 2) + mat(2, 1)) / z4,
                      z4 / kFour, (mat(1, 0) - mat(0, 1)) / z4));
 }
 
-void Rotation::GetAxisAndAngle(VectorType* axis, double* angle) const {
-  VectorType vec(quat_[0], quat_[1], quat_[2]);
-  if (Normalize(&vec)) {
-    *angle = 2 * acos(quat_[3]);
-    *axis = vec;
+template <typename Scalar>
+void BasicRotation<Scalar>::GetAxisAndAngle(VectorType* axis,
+                                            Scalar* angle) const {
+  const VectorType vec = Log();
+  const Scalar length = Length(vec);
+  if (length > 0) {
+    *angle = length;
+    *axis = vec / length;
   } else {
     *axis = VectorType(1, 0, 0);
     *angle = 0.0;
   }
 }
 
-Rotation Rotation::RotateInto(const VectorType& from, const VectorType& to) {
-  static const double kTolerance = std::numeric_limits<double>::epsilon() * 100;
+template <typename Scalar>
+BasicRotation<Scalar> BasicRotation<Scalar>::RotateInto(const VectorType& from,
+                                                        const VectorType& to) {
+  static const Scalar kTolerance = std::numeric_limits<Scalar>::epsilon() * 100;
 
   // Directly build the quaternion using the following technique:
   // http://lolengine.net/blog/2014/02/24/quaternion-from-two-vectors-final
-  const double norm_u_norm_v = sqrt(LengthSquared(from) * LengthSquared(to));
-  double real_part = norm_u_norm_v + Dot(from, to);
+  const Scalar norm_u_norm_v =
+      std::sqrt(LengthSquared(from) * LengthSquared(to));
+  Scalar real_part = norm_u_norm_v + Dot(from, to);
   VectorType w;
   if (real_part < kTolerance * norm_u_norm_v) {
     // If |from| and |to| are exactly opposite, rotate 180 degrees around an
     // arbitrary orthogonal axis. Axis normalization can happen later, when we
     // normalize the quaternion.
     real_part = 0.0;
-    w = (abs(from[0]) > abs(from[2])) ? VectorType(-from[1], from[0], 0)
-                                      : VectorType(0, -from[2], from[1]);
+    w = (std::abs(from[0]) > std::abs(from[2]))
+            ? VectorType(-from[1], from[0], 0)
+            : VectorType(0, -from[2], from[1]);
   } else {
     // Otherwise, build the quaternion the standard way.
     w = Cross(from, to);
   }
 
   // Build and return a normalized quaternion.
-  // Note that Rotation::FromQuaternion automatically performs normalization.
-  return Rotation::FromQuaternion(QuaternionType(w[0], w[1], w[2], real_part));
+  // Note that BasicRotation::FromQuaternion automatically performs
+  // normalization.
+  return FromQuaternion(QuaternionType(w[0], w[1], w[2], real_part));
 }
 
-Rotation::VectorType Rotation::operator*(const Rotation::VectorType& v) const {
+template <typename Scalar>
+typename BasicRotation<Scalar>::VectorType BasicRotation<Scalar>::operator*(
+    const VectorType& v) const {
   return ApplyToVector(v);
 }
 
-double Rotation::GetYawAngle() const {
-  const double x = quat_[0];
-  const double y = quat_[1];
-  const double z = quat_[2];
-  const double w = quat_[3];
+template <typename Scalar>
+Scalar BasicRotation<Scalar>::GetYawAngle() const {
+  const Scalar x = quat_[0];
+  const Scalar y = quat_[1];
+  const Scalar z = quat_[2];
+  const Scalar w = quat_[3];
 
-  const double siny_cosp = 2. * (w * y + z * x);
-  const double cosy_cosp = 1. - 2. * (x * x + y * y);
+  const Scalar siny_cosp = 2 * (w * y + z * x);
+  const Scalar cosy_cosp = 1 - 2 * (x * x + y * y);
   return std::atan2(siny_cosp, cosy_cosp);
 }
 
-double Rotation::GetPitchAngle() const {
-  const double x = quat_[0];
-  const double y = quat_[1];
-  const double z = quat_[2];
-  const double w = quat_[3];
+template <typename Scalar>
+Scalar BasicRotation<Scalar>::GetPitchAngle() const {
+  const Scalar x = quat_[0];
+  const Scalar y = quat_[1];
+  const Scalar z = quat_[2];
+  const Scalar w = quat_[3];
 
-  const double sinp = 2. * (w * x - y * z);
-  return std::abs(sinp) >= 1. ? std::copysign(M_PI / 2., sinp)
-                              : std::asin(sinp);
+  const Scalar sinp = 2 * (w * x - y * z);
+  return std::abs(sinp) >= 1 ? std::copysign(Scalar(M_PI / 2.), sinp)
+                             : std::asin(sinp);
 }
 
-double Rotation::GetRollAngle() const {
-  const double x = quat_[0];
-  const double y = quat_[1];
-  const double z = quat_[2];
-  const double w = quat_[3];
+template <typename Scalar>
+Scalar BasicRotation<Scalar>::GetRollAngle() const {
+  const Scalar x = quat_[0];
+  const Scalar y = quat_[1];
+  const Scalar z = quat_[2];
+  const Scalar w = quat_[3];
 
-  const double sinr_cosp = 2. * (w * z + x * y);
-  const double cosr_cosp = 1. - 2. * (z * z + x * x);
+  const Scalar sinr_cosp = 2 * (w * z + x * y);
+  const Scalar cosr_cosp = 1 - 2 * (z * z + x * x);
   return std::atan2(sinr_cosp, cosr_cosp);
 }
 
+template class BasicRotation<double>;
+template class BasicRotation<float>;
+
 }  // namespace cardboard
@@ -16,68 +16,124 @@
 #ifndef CARDBOARD_SDK_UTIL_ROTATION_H_
 #define CARDBOARD_SDK_UTIL_ROTATION_H_
 
+#include <type_traits>
+
 #include "util/matrix_3x3.h"
+#include "util/simd.h"
 #include "util/vector.h"
 #include "util/vectorutils.h"
 
 namespace cardboard {
 
-// The Rotation class represents a rotation around a 3-dimensional axis. It
-// uses normalized quaternions internally to make the math robust.
-class Rotation {
+// The BasicRotation class represents a rotation around a 3-dimensional axis. It
+// uses normalized quaternions internally to make the math robust. Use the
+// Rotation (double) and Rotationf (float) typedefs.
+//
+// Construction from a normalized quaternion, inversion and composition are
+// constexpr, so that fixed rotations can be compile-time constants.
+template <typename Scalar>
+class BasicRotation {
  public:
   // Convenience typedefs for vector of the correct type.
-  typedef Vector<3> VectorType;
-  typedef Vector<4> QuaternionType;
+  typedef Vector<3, Scalar> VectorType;
+  typedef Vector<4, Scalar> QuaternionType;
 
   // The default constructor creates an identity Rotation, which has no effect.
-  Rotation() { quat_.Set(0, 0, 0, 1); }
+  constexpr BasicRotation() : quat_(0, 0, 0, 1) {}
 
   // Returns an identity Rotation, which has no effect.
-  static Rotation Identity() { return Rotation(); }
+  static constexpr BasicRotation Identity() { return BasicRotation(); }
 
   // Sets the Rotation from a quaternion (4D vector), which is first normalized.
   void SetQuaternion(const QuaternionType& quaternion) {
-    quat_ = Normalized(quaternion);
+    quat_ = quaternion;
+    if (!simd::QuaternionNormalize(quat_.Data())) {
+      quat_ = QuaternionType::Zero();
+    }
   }
 
   // Returns the Rotation as a normalized quaternion (4D vector).
-  const QuaternionType& GetQuaternion() const { return quat_; }
+  constexpr const QuaternionType& GetQuaternion() const { return quat_; }
+
+  // Converts a rotation of another scalar type. The quaternion is not
+  // normalized again: rounding a unit quaternion keeps it unit length to the
+  // precision of the narrower type. This is a plain copy when the scalar types
+  // match.
+  template <typename OtherScalar>
+  static constexpr BasicRotation Cast(const BasicRotation<OtherScalar>& r) {
+    if constexpr (std::is_same_v<OtherScalar, Scalar>) {
+      return r;
+    } else {
+      BasicRotation result;
+      result.quat_ = QuaternionType(r.GetQuaternion());
+      return result;
+    }
+  }
 
   // Sets the Rotation to rotate by the given angle around the given axis,
   // following the right-hand rule. The axis does not need to be unit
   // length. If it is zero length, this results in an identity Rotation.
-  void SetAxisAndAngle(const VectorType& axis, double angle);
+  void SetAxisAndAngle(const VectorType& axis, Scalar angle);
 
   // Returns the right-hand rule axis and angle corresponding to the
-  // Rotation. If the Rotation is the identity rotation, this returns the +X
-  // axis and an angle of 0.
-  void GetAxisAndAngle(VectorType* axis, double* angle) const;
+  // Rotation, with the angle in [0, pi]. If the Rotation is the identity
+  // rotation, this returns the +X axis and an angle of 0.
+  void GetAxisAndAngle(VectorType* axis, Scalar* angle) const;
+
+  // Returns the Rotation by the angle |v| around the axis v / |v|, i.e. the
+  // exponential map of the rotation vector @p v. Small angles, such as the
+  // rotation between two sensor samples, are computed with a Taylor expansion
+  // instead of sin() and cos().
+  static BasicRotation Exp(const VectorType& v);
+
+  // Returns the rotation vector of the Rotation, i.e. its logarithm map, the
+  // inverse of Exp(). The angle is in [0, pi]. This uses atan2() rather than
+  // acos(), so it stays accurate near the identity, and a Taylor expansion
+  // for small angles.
+  VectorType Log() const;
+
+  // Returns the Rotation around the same axis by @p t times the angle.
+  BasicRotation Pow(Scalar t) const { return Exp(Log() * t); }
+
+  // Returns the spherical linear interpolation from @p r0 (t = 0) to @p r1
+  // (t = 1) along the shortest arc.
+  static BasicRotation Slerp(const BasicRotation& r0, const BasicRotation& r1,
+                             Scalar t) {
+    return r0 * (-r0 * r1).Pow(t);
+  }
 
   // Convenience function that constructs and returns a Rotation given an axis
   // and angle.
-  static Rotation FromAxisAndAngle(const VectorType& axis, double angle) {
-    Rotation r;
+  static BasicRotation FromAxisAndAngle(const VectorType& axis, Scalar angle) {
+    BasicRotation r;
     r.SetAxisAndAngle(axis, angle);
     return r;
   }
 
   // Convenience function that constructs and returns a Rotation given a
   // quaternion.
-  static Rotation FromQuaternion(const QuaternionType& quat) {
-    Rotation r;
+  static BasicRotation FromQuaternion(const QuaternionType& quat) {
+    BasicRotation r;
     r.SetQuaternion(quat);
     return r;
   }
 
+  // Constructs and returns a Rotation given a quaternion that is already
+  // normalized. Unlike FromQuaternion(), this does not normalize it again, so
+  // it can be used in constant expressions.
+  static constexpr BasicRotation FromNormalizedQuaternion(
+      const QuaternionType& quat) {
+    return BasicRotation(quat[0], quat[1], quat[2], quat[3]);
+  }
+
   // Convenience function that constructs and returns a Rotation given a
   // rotation matrix R with $R^\top R = I && det(R) = 1$.
-  static Rotation FromRotationMatrix(const Matrix3x3& mat);
+  static BasicRotation FromRotationMatrix(const BasicMatrix3x3<Scalar>& mat);
 
   // Convenience function that constructs and returns a Rotation given Euler
   // angles that are applied in the order of rotate-Z by roll, rotate-X by
   // pitch, rotate-Y by yaw (same as GetRollPitchYaw).
-  static Rotation FromRollPitchYaw(double roll, double pitch, double yaw) {
+  static BasicRotation FromRollPitchYaw(Scalar roll, Scalar pitch, Scalar yaw) {
     VectorType x(1, 0, 0), y(0, 1, 0), z(0, 0, 1);
     return FromAxisAndAngle(z, roll) *
            (FromAxisAndAngle(x, pitch) * FromAxisAndAngle(y, yaw));
@@ -86,7 +142,7 @@ class Rotation {
   // Convenience function that constructs and returns a Rotation given Euler
   // angles that are applied in the order of rotate-Y by yaw, rotate-X by
   // pitch, rotate-Z by roll (same as GetYawPitchRoll).
-  static Rotation FromYawPitchRoll(double yaw, double pitch, double roll) {
+  static BasicRotation FromYawPitchRoll(Scalar yaw, Scalar pitch, Scalar roll) {
     VectorType x(1, 0, 0), y(0, 1, 0), z(0, 0, 1);
     return FromAxisAndAngle(y, yaw) *
            (FromAxisAndAngle(x, pitch) * FromAxisAndAngle(z, roll));
@@ -95,30 +151,34 @@ class Rotation {
   // Constructs and returns a Rotation that rotates one vector to another along
   // the shortest arc. This returns an identity rotation if either vector has
   // zero length.
-  static Rotation RotateInto(const VectorType& from, const VectorType& to);
+  static BasicRotation RotateInto(const VectorType& from, const VectorType& to);
 
   // The negation operator returns the inverse rotation.
-  friend Rotation operator-(const Rotation& r) {
+  friend constexpr BasicRotation operator-(const BasicRotation& r) {
     // Because we store normalized quaternions, the inverse is found by
     // negating the vector part.
-    return Rotation(-r.quat_[0], -r.quat_[1], -r.quat_[2], r.quat_[3]);
+    return BasicRotation(-r.quat_[0], -r.quat_[1], -r.quat_[2], r.quat_[3]);
   }
 
   // Appends a rotation to this one.
-  Rotation& operator*=(const Rotation& r) {
-    const QuaternionType& qr = r.quat_;
-    QuaternionType& qt = quat_;
-    SetQuaternion(QuaternionType(
-        qr[3] * qt[0] + qr[0] * qt[3] + qr[2] * qt[1] - qr[1] * qt[2],
-        qr[3] * qt[1] + qr[1] * qt[3] + qr[0] * qt[2] - qr[2] * qt[0],
-        qr[3] * qt[2] + qr[2] * qt[3] + qr[1] * qt[0] - qr[0] * qt[1],
-        qr[3] * qt[3] - qr[0] * qt[0] - qr[1] * qt[1] - qr[2] * qt[2]));
+  constexpr BasicRotation& operator*=(const BasicRotation& r) {
+    // Both factors are unit quaternions, so the product only needs its
+    // rounding errors removed rather than a full normalization.
+    if (std::is_constant_evaluated()) {
+      simd::scalar::QuaternionMultiply(quat_.Data(), r.quat_.Data(),
+                                       quat_.Data());
+      simd::scalar::QuaternionRenormalize(quat_.Data());
+    } else {
+      simd::QuaternionMultiply(quat_.Data(), r.quat_.Data(), quat_.Data());
+      simd::QuaternionRenormalize(quat_.Data());
+    }
     return *this;
   }
 
   // Binary multiplication operator - returns a composite Rotation.
-  friend const Rotation operator*(const Rotation& r0, const Rotation& r1) {
-    Rotation r = r0;
+  friend constexpr const BasicRotation operator*(const BasicRotation& r0,
+                                                 const BasicRotation& r1) {
+    BasicRotation r = r0;
     r *= r1;
     return r;
   }
@@ -138,22 +198,22 @@ class Rotation {
   // @see https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles
   //
   // @return Angle in radians.
-  double GetYawAngle() const;
-  double GetPitchAngle() const;
-  double GetRollAngle() const;
+  Scalar GetYawAngle() const;
+  Scalar GetPitchAngle() const;
+  Scalar GetRollAngle() const;
   // @}
 
  private:
   // Private constructor that builds a Rotation from quaternion components.
-  Rotation(double q0, double q1, double q2, double q3)
+  constexpr BasicRotation(Scalar q0, Scalar q1, Scalar q2, Scalar q3)
       : quat_(q0, q1, q2, q3) {}
 
   // Applies a Rotation to a Vector to rotate the Vector. Method borrowed from:
   // http://blog.molecular-matters.com/2013/05/24/a-faster-quaternion-vector-multiplication/
   VectorType ApplyToVector(const VectorType& v) const {
-    VectorType im(quat_[0], quat_[1], quat_[2]);
-    VectorType temp = 2.0 * Cross(im, v);
-    return v + quat_[3] * temp + Cross(im, temp);
+    VectorType result;
+    simd::QuaternionRotate(quat_.Data(), v.Data(), result.Data());
+    return result;
   }
 
   // The rotation represented as a normalized quaternion. (Unit quaternions are
@@ -163,6 +223,12 @@ class Rotation {
   QuaternionType quat_;
 };
 
+typedef BasicRotation<double> Rotation;
+typedef BasicRotation<float> Rotationf;
+
+extern template class BasicRotation<double>;
+extern template class BasicRotation<float>;
+
 }  // namespace cardboard
 
 #endif  // CARDBOARD_SDK_UTIL_ROTATION_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_SEQLOCK_H_
+#define CARDBOARD_SDK_UTIL_SEQLOCK_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace cardboard {
+
+// Single writer, multiple reader sequence lock holding a snapshot of a
+// trivially copyable value.
+//
+// The writer never waits for readers and readers never take a lock: Load()
+// only retries while a Store() is copying the value, which is a handful of
+// word stores, so readers cannot be stalled by whatever computation the
+// writer does before publishing. Writers must be serialized by the caller.
+//
+// The value is kept in relaxed atomic words rather than as a plain T, so that
+// the concurrent reads that the sequence counter later discards are not data
+// races.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock requires a trivially copyable type.");
+
+ public:
+  SeqLock() : sequence_(0) {
+    for (auto& word : words_) {
+      word.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  explicit SeqLock(const T& value) : SeqLock() { Store(value); }
+
+  // Publishes @p value. Must not be called concurrently with another Store().
+  void Store(const T& value) {
+    std::array<uint64_t, kWordCount> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kWordCount; ++i) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Returns the latest published value. Safe to call from any thread.
+  T Load() const {
+    std::array<uint64_t, kWordCount> words;
+    uint32_t sequence_before;
+    uint32_t sequence_after;
+    do {
+      sequence_before = sequence_.load(std::memory_order_acquire);
+      for (size_t i = 0; i < kWordCount; ++i) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      sequence_after = sequence_.load(std::memory_order_relaxed);
+    } while ((sequence_before & 1) != 0 || sequence_before != sequence_after);
+
+    T value;
+    std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+    return value;
+  }
+
+ private:
+  static constexpr size_t kWordCount =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  // Odd while a Store() is in progress.
+  std::atomic<uint32_t> sequence_;
+  std::array<std::atomic<uint64_t>, kWordCount> words_;
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+};
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_SEQLOCK_H_
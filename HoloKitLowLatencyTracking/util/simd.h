@@ -0,0 +1,354 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_SIMD_H_
+#define CARDBOARD_SDK_UTIL_SIMD_H_
+
+//
+// This file contains the arithmetic kernels behind Rotation and Matrix3x3.
+// The implementation is selected at compile time from the target instruction
+// set: AVX2 or SSE2 on x86, NEON on arm64, and plain scalar code otherwise.
+// Defining CARDBOARD_SDK_DISABLE_SIMD forces the scalar implementation.
+//
+// Quaternions are 4 contiguous scalars with the vector part first
+// (x, y, z, w) and matrices are 9 contiguous scalars in row-major order,
+// matching the layout of Vector<4> and Matrix3x3. Every kernel has a double
+// and a float overload; the float ones only vectorize the quaternion product,
+// the rest compile to the scalar code.
+//
+
+#include <cmath>
+
+#if !defined(CARDBOARD_SDK_DISABLE_SIMD)
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define CARDBOARD_SDK_SIMD_NEON 1
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#define CARDBOARD_SDK_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define CARDBOARD_SDK_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+#endif
+
+namespace cardboard {
+namespace simd {
+
+// Scalar implementations, used for float and for double when no SIMD
+// instruction set is available. The quaternion product and renormalization
+// are constexpr so that Rotation can use them in constant expressions.
+namespace scalar {
+
+template <typename Scalar>
+constexpr void QuaternionMultiply(const Scalar* a, const Scalar* b,
+                               Scalar* result) {
+  const Scalar x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+  const Scalar y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+  const Scalar z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+  const Scalar w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+  result[0] = x;
+  result[1] = y;
+  result[2] = z;
+  result[3] = w;
+}
+
+template <typename Scalar>
+inline bool QuaternionNormalize(Scalar* q) {
+  const Scalar norm_squared =
+      q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+  if (norm_squared == 0) {
+    return false;
+  }
+  const Scalar scale = Scalar(1) / std::sqrt(norm_squared);
+  for (int i = 0; i < 4; ++i) {
+    q[i] *= scale;
+  }
+  return true;
+}
+
+template <typename Scalar>
+constexpr void QuaternionRenormalize(Scalar* q) {
+  const Scalar norm_squared =
+      q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+  const Scalar scale = Scalar(0.5) * (Scalar(3) - norm_squared);
+  for (int i = 0; i < 4; ++i) {
+    q[i] *= scale;
+  }
+}
+
+template <typename Scalar>
+inline void Matrix3x3Multiply(const Scalar* a, const Scalar* b,
+                              Scalar* result) {
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      result[3 * row + col] = a[3 * row] * b[col] +
+                              a[3 * row + 1] * b[3 + col] +
+                              a[3 * row + 2] * b[6 + col];
+    }
+  }
+}
+
+}  // namespace scalar
+
+#if defined(CARDBOARD_SDK_SIMD_NEON)
+
+// Two-lane helpers shared by the quaternion kernels. A quaternion is handled
+// as its (x, y) and (z, w) halves.
+typedef float64x2_t Double2;
+inline Double2 Load2(const double* p) { return vld1q_f64(p); }
+inline void Store2(double* p, Double2 v) { vst1q_f64(p, v); }
+inline Double2 Splat2(double s) { return vdupq_n_f64(s); }
+inline Double2 Set2(double lo, double hi) {
+  const double values[2] = {lo, hi};
+  return vld1q_f64(values);
+}
+inline Double2 Add2(Double2 a, Double2 b) { return vaddq_f64(a, b); }
+inline Double2 Sub2(Double2 a, Double2 b) { return vsubq_f64(a, b); }
+inline Double2 Mul2(Double2 a, Double2 b) { return vmulq_f64(a, b); }
+// Returns a + b * c.
+inline Double2 MulAdd2(Double2 a, Double2 b, Double2 c) {
+  return vfmaq_f64(a, b, c);
+}
+inline Double2 Swap2(Double2 v) { return vextq_f64(v, v, 1); }
+inline double Sum2(Double2 v) { return vaddvq_f64(v); }
+
+#elif defined(CARDBOARD_SDK_SIMD_SSE2) || defined(CARDBOARD_SDK_SIMD_AVX2)
+
+typedef __m128d Double2;
+inline Double2 Load2(const double* p) { return _mm_loadu_pd(p); }
+inline void Store2(double* p, Double2 v) { _mm_storeu_pd(p, v); }
+inline Double2 Splat2(double s) { return _mm_set1_pd(s); }
+inline Double2 Set2(double lo, double hi) { return _mm_set_pd(hi, lo); }
+inline Double2 Add2(Double2 a, Double2 b) { return _mm_add_pd(a, b); }
+inline Double2 Sub2(Double2 a, Double2 b) { return _mm_sub_pd(a, b); }
+inline Double2 Mul2(Double2 a, Double2 b) { return _mm_mul_pd(a, b); }
+inline Double2 MulAdd2(Double2 a, Double2 b, Double2 c) {
+  return _mm_add_pd(a, _mm_mul_pd(b, c));
+}
+inline Double2 Swap2(Double2 v) { return _mm_shuffle_pd(v, v, 1); }
+inline double Sum2(Double2 v) {
+  return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+#endif
+
+// Computes the Hamilton product @p result = @p a * @p b. @p result may alias
+// either input.
+inline void QuaternionMultiply(const double* a, const double* b,
+                               double* result) {
+#if defined(CARDBOARD_SDK_SIMD_AVX2)
+  // result = aw * (bx, by, bz, bw) + ax * (bw, -bz, by, -bx)
+  //        + ay * (bz, bw, -bx, -by) + az * (-by, bx, bw, -bz)
+  const __m256d qb = _mm256_loadu_pd(b);
+  __m256d sum = _mm256_mul_pd(_mm256_set1_pd(a[3]), qb);
+  sum = _mm256_add_pd(
+      sum, _mm256_mul_pd(_mm256_set1_pd(a[0]),
+                         _mm256_mul_pd(_mm256_permute4x64_pd(qb, 0x1B),
+                                       _mm256_set_pd(-1, 1, -1, 1))));
+  sum = _mm256_add_pd(
+      sum, _mm256_mul_pd(_mm256_set1_pd(a[1]),
+                         _mm256_mul_pd(_mm256_permute4x64_pd(qb, 0x4E),
+                                       _mm256_set_pd(-1, -1, 1, 1))));
+  sum = _mm256_add_pd(
+      sum, _mm256_mul_pd(_mm256_set1_pd(a[2]),
+                         _mm256_mul_pd(_mm256_permute4x64_pd(qb, 0xB1),
+                                       _mm256_set_pd(-1, 1, 1, -1))));
+  _mm256_storeu_pd(result, sum);
+#elif defined(CARDBOARD_SDK_SIMD_NEON) || defined(CARDBOARD_SDK_SIMD_SSE2)
+  // Same expansion as above, split into (x, y) and (z, w) halves.
+  const Double2 b_lo = Load2(b);
+  const Double2 b_hi = Load2(b + 2);
+  const Double2 b_lo_swapped = Swap2(b_lo);
+  const Double2 b_hi_swapped = Swap2(b_hi);
+  const Double2 plus_minus = Set2(1, -1);
+  const Double2 ax = Splat2(a[0]);
+  const Double2 ay = Splat2(a[1]);
+  const Double2 az = Splat2(a[2]);
+  const Double2 aw = Splat2(a[3]);
+
+  Double2 lo = Mul2(aw, b_lo);
+  lo = MulAdd2(lo, ax, Mul2(b_hi_swapped, plus_minus));
+  lo = MulAdd2(lo, ay, b_hi);
+  lo = Sub2(lo, Mul2(az, Mul2(b_lo_swapped, plus_minus)));
+
+  Double2 hi = Mul2(aw, b_hi);
+  hi = MulAdd2(hi, ax, Mul2(b_lo_swapped, plus_minus));
+  hi = Sub2(hi, Mul2(ay, b_lo));
+  hi = MulAdd2(hi, az, Mul2(b_hi_swapped, plus_minus));
+
+  Store2(result, lo);
+  Store2(result + 2, hi);
+#else
+  scalar::QuaternionMultiply(a, b, result);
+#endif
+}
+
+inline void QuaternionMultiply(const float* a, const float* b,
+                               float* result) {
+#if defined(CARDBOARD_SDK_SIMD_SSE2) || defined(CARDBOARD_SDK_SIMD_AVX2)
+  // Same expansion as the double AVX2 kernel, on a single float register.
+  const __m128 qb = _mm_loadu_ps(b);
+  __m128 sum = _mm_mul_ps(_mm_set1_ps(a[3]), qb);
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a[0]),
+                                   _mm_mul_ps(_mm_shuffle_ps(qb, qb, 0x1B),
+                                              _mm_set_ps(-1, 1, -1, 1))));
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a[1]),
+                                   _mm_mul_ps(_mm_shuffle_ps(qb, qb, 0x4E),
+                                              _mm_set_ps(-1, -1, 1, 1))));
+  sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(a[2]),
+                                   _mm_mul_ps(_mm_shuffle_ps(qb, qb, 0xB1),
+                                              _mm_set_ps(-1, 1, 1, -1))));
+  _mm_storeu_ps(result, sum);
+#elif defined(CARDBOARD_SDK_SIMD_NEON)
+  static const float kSignsX[4] = {1, -1, 1, -1};
+  static const float kSignsY[4] = {1, 1, -1, -1};
+  static const float kSignsZ[4] = {-1, 1, 1, -1};
+  const float32x4_t qb = vld1q_f32(b);
+  // (by, bx, bw, bz), then (bw, bz, by, bx) and (bz, bw, bx, by).
+  const float32x4_t pairs_swapped = vrev64q_f32(qb);
+  const float32x4_t reversed = vextq_f32(pairs_swapped, pairs_swapped, 2);
+  const float32x4_t halves_swapped = vextq_f32(qb, qb, 2);
+  float32x4_t sum = vmulq_n_f32(qb, a[3]);
+  sum = vfmaq_n_f32(sum, vmulq_f32(reversed, vld1q_f32(kSignsX)), a[0]);
+  sum = vfmaq_n_f32(sum, vmulq_f32(halves_swapped, vld1q_f32(kSignsY)), a[1]);
+  sum = vfmaq_n_f32(sum, vmulq_f32(pairs_swapped, vld1q_f32(kSignsZ)), a[2]);
+  vst1q_f32(result, sum);
+#else
+  scalar::QuaternionMultiply(a, b, result);
+#endif
+}
+
+// Scales the 4 elements of @p q to unit length. Returns false and leaves @p q
+// unchanged if it has zero length.
+inline bool QuaternionNormalize(double* q) {
+#if defined(CARDBOARD_SDK_SIMD_AVX2)
+  const __m256d v = _mm256_loadu_pd(q);
+  const __m256d squares = _mm256_mul_pd(v, v);
+  const __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(squares),
+                                   _mm256_extractf128_pd(squares, 1));
+  const double norm_squared =
+      _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+  if (norm_squared == 0) {
+    return false;
+  }
+  _mm256_storeu_pd(
+      q, _mm256_mul_pd(v, _mm256_set1_pd(1.0 / std::sqrt(norm_squared))));
+  return true;
+#elif defined(CARDBOARD_SDK_SIMD_NEON) || defined(CARDBOARD_SDK_SIMD_SSE2)
+  const Double2 lo = Load2(q);
+  const Double2 hi = Load2(q + 2);
+  const double norm_squared = Sum2(MulAdd2(Mul2(lo, lo), hi, hi));
+  if (norm_squared == 0) {
+    return false;
+  }
+  const Double2 scale = Splat2(1.0 / std::sqrt(norm_squared));
+  Store2(q, Mul2(lo, scale));
+  Store2(q + 2, Mul2(hi, scale));
+  return true;
+#else
+  return scalar::QuaternionNormalize(q);
+#endif
+}
+
+inline bool QuaternionNormalize(float* q) {
+  return scalar::QuaternionNormalize(q);
+}
+
+// Scales the 4 elements of @p q, which must already be unit length up to
+// accumulated rounding errors, back to unit length. This uses one Newton step
+// of 1 / sqrt(n) around n = 1, which avoids the square root and the division
+// of QuaternionNormalize() and is exact to double precision for
+// |n - 1| < 1e-8.
+inline void QuaternionRenormalize(double* q) {
+#if defined(CARDBOARD_SDK_SIMD_AVX2)
+  const __m256d v = _mm256_loadu_pd(q);
+  const __m256d squares = _mm256_mul_pd(v, v);
+  const __m128d pairs = _mm_add_pd(_mm256_castpd256_pd128(squares),
+                                   _mm256_extractf128_pd(squares, 1));
+  const double norm_squared =
+      _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+  _mm256_storeu_pd(
+      q, _mm256_mul_pd(v, _mm256_set1_pd(0.5 * (3.0 - norm_squared))));
+#elif defined(CARDBOARD_SDK_SIMD_NEON) || defined(CARDBOARD_SDK_SIMD_SSE2)
+  const Double2 lo = Load2(q);
+  const Double2 hi = Load2(q + 2);
+  const double norm_squared = Sum2(MulAdd2(Mul2(lo, lo), hi, hi));
+  const Double2 scale = Splat2(0.5 * (3.0 - norm_squared));
+  Store2(q, Mul2(lo, scale));
+  Store2(q + 2, Mul2(hi, scale));
+#else
+  scalar::QuaternionRenormalize(q);
+#endif
+}
+
+// In float, the Newton step is exact for |n - 1| < 1e-4.
+inline void QuaternionRenormalize(float* q) {
+  scalar::QuaternionRenormalize(q);
+}
+
+// Rotates the 3 elements of @p v by the unit quaternion @p q into @p result,
+// as v + w * t + u x t with u the vector part of q and t = 2 * u x v. @p result
+// may alias @p v.
+//
+// A 3-vector does not fill whole SIMD registers, so this stays a straight line
+// of scalar operations that the compiler can schedule freely.
+template <typename Scalar>
+inline void QuaternionRotate(const Scalar* q, const Scalar* v,
+                             Scalar* result) {
+  const Scalar tx = 2 * (q[1] * v[2] - q[2] * v[1]);
+  const Scalar ty = 2 * (q[2] * v[0] - q[0] * v[2]);
+  const Scalar tz = 2 * (q[0] * v[1] - q[1] * v[0]);
+  const Scalar x = v[0] + q[3] * tx + (q[1] * tz - q[2] * ty);
+  const Scalar y = v[1] + q[3] * ty + (q[2] * tx - q[0] * tz);
+  const Scalar z = v[2] + q[3] * tz + (q[0] * ty - q[1] * tx);
+  result[0] = x;
+  result[1] = y;
+  result[2] = z;
+}
+
+// Computes the 3x3 matrix product @p result = @p a * @p b. @p result must not
+// alias either input.
+inline void Matrix3x3Multiply(const double* a, const double* b,
+                              double* result) {
+#if defined(CARDBOARD_SDK_SIMD_NEON) || defined(CARDBOARD_SDK_SIMD_SSE2) || \
+    defined(CARDBOARD_SDK_SIMD_AVX2)
+  // Each result row is a combination of the rows of b. The first two columns
+  // go through a SIMD register, the third one through a scalar.
+  const Double2 b0 = Load2(b);
+  const Double2 b1 = Load2(b + 3);
+  const Double2 b2 = Load2(b + 6);
+  for (int row = 0; row < 3; ++row) {
+    const double* a_row = a + 3 * row;
+    Double2 lo = Mul2(Splat2(a_row[0]), b0);
+    lo = MulAdd2(lo, Splat2(a_row[1]), b1);
+    lo = MulAdd2(lo, Splat2(a_row[2]), b2);
+    Store2(result + 3 * row, lo);
+    result[3 * row + 2] =
+        a_row[0] * b[2] + a_row[1] * b[5] + a_row[2] * b[8];
+  }
+#else
+  scalar::Matrix3x3Multiply(a, b, result);
+#endif
+}
+
+inline void Matrix3x3Multiply(const float* a, const float* b, float* result) {
+  scalar::Matrix3x3Multiply(a, b, result);
+}
+
+}  // namespace simd
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_SIMD_H_
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "util/symmetric_matrix_3x3.h"
+
+namespace cardboard {
+
+namespace {
+
+// Returns m * p for a full matrix m and a symmetric matrix p.
+template <typename Scalar>
+BasicMatrix3x3<Scalar> Product(const BasicMatrix3x3<Scalar>& m,
+                               const BasicSymmetricMatrix3x3<Scalar>& p) {
+  BasicMatrix3x3<Scalar> result;
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      result(row, col) = m(row, 0) * p(0, col) + m(row, 1) * p(1, col) +
+                         m(row, 2) * p(2, col);
+    }
+  }
+  return result;
+}
+
+// Returns the element (row, col) of a * b'.
+template <typename Scalar>
+Scalar ProductWithTransposeElement(const BasicMatrix3x3<Scalar>& a,
+                                   const BasicMatrix3x3<Scalar>& b, int row,
+                                   int col) {
+  return a(row, 0) * b(col, 0) + a(row, 1) * b(col, 1) + a(row, 2) * b(col, 2);
+}
+
+// Returns a * b' when the caller knows the result to be symmetric, computing
+// only its upper triangle.
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> SymmetricProductWithTranspose(
+    const BasicMatrix3x3<Scalar>& a, const BasicMatrix3x3<Scalar>& b) {
+  return BasicSymmetricMatrix3x3<Scalar>(
+      ProductWithTransposeElement(a, b, 0, 0),
+      ProductWithTransposeElement(a, b, 0, 1),
+      ProductWithTransposeElement(a, b, 0, 2),
+      ProductWithTransposeElement(a, b, 1, 1),
+      ProductWithTransposeElement(a, b, 1, 2),
+      ProductWithTransposeElement(a, b, 2, 2));
+}
+
+}  // namespace
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar>::BasicSymmetricMatrix3x3() : elem_{} {}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar>::BasicSymmetricMatrix3x3(Scalar m00,
+                                                         Scalar m01,
+                                                         Scalar m02,
+                                                         Scalar m11,
+                                                         Scalar m12,
+                                                         Scalar m22)
+    : elem_{{m00, m01, m02, m11, m12, m22}} {}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> BasicSymmetricMatrix3x3<Scalar>::Zero() {
+  return BasicSymmetricMatrix3x3();
+}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> BasicSymmetricMatrix3x3<Scalar>::Identity() {
+  return BasicSymmetricMatrix3x3(1, 0, 0, 1, 0, 1);
+}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> BasicSymmetricMatrix3x3<Scalar>::FromMatrix(
+    const BasicMatrix3x3<Scalar>& m) {
+  const Scalar half = 0.5;
+  return BasicSymmetricMatrix3x3(m(0, 0), half * (m(0, 1) + m(1, 0)),
+                                 half * (m(0, 2) + m(2, 0)), m(1, 1),
+                                 half * (m(1, 2) + m(2, 1)), m(2, 2));
+}
+
+template <typename Scalar>
+BasicMatrix3x3<Scalar> BasicSymmetricMatrix3x3<Scalar>::ToMatrix() const {
+  return BasicMatrix3x3<Scalar>(elem_[0], elem_[1], elem_[2], elem_[1],
+                                elem_[3], elem_[4], elem_[2], elem_[4],
+                                elem_[5]);
+}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> BasicSymmetricMatrix3x3<Scalar>::Addition(
+    const BasicSymmetricMatrix3x3& lhs, const BasicSymmetricMatrix3x3& rhs) {
+  BasicSymmetricMatrix3x3 result;
+  for (int i = 0; i < 6; ++i) {
+    result.elem_[i] = lhs.elem_[i] + rhs.elem_[i];
+  }
+  return result;
+}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> BasicSymmetricMatrix3x3<Scalar>::Scale(
+    const BasicSymmetricMatrix3x3& m, Scalar s) {
+  BasicSymmetricMatrix3x3 result;
+  for (int i = 0; i < 6; ++i) {
+    result.elem_[i] = m.elem_[i] * s;
+  }
+  return result;
+}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> SandwichProduct(
+    const BasicMatrix3x3<Scalar>& m, const BasicSymmetricMatrix3x3<Scalar>& p) {
+  return SymmetricProductWithTranspose(Product(m, p), m);
+}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> PredictCovariance(
+    const BasicMatrix3x3<Scalar>& f, const BasicSymmetricMatrix3x3<Scalar>& p,
+    Scalar dt_squared, const BasicSymmetricMatrix3x3<Scalar>& q) {
+  const BasicMatrix3x3<Scalar> fp = Product(f, p);
+  return BasicSymmetricMatrix3x3<Scalar>(
+      ProductWithTransposeElement(fp, f, 0, 0) + dt_squared * q(0, 0),
+      ProductWithTransposeElement(fp, f, 0, 1) + dt_squared * q(0, 1),
+      ProductWithTransposeElement(fp, f, 0, 2) + dt_squared * q(0, 2),
+      ProductWithTransposeElement(fp, f, 1, 1) + dt_squared * q(1, 1),
+      ProductWithTransposeElement(fp, f, 1, 2) + dt_squared * q(1, 2),
+      ProductWithTransposeElement(fp, f, 2, 2) + dt_squared * q(2, 2));
+}
+
+template <typename Scalar>
+BasicMatrix3x3<Scalar> ProductWithTranspose(
+    const BasicSymmetricMatrix3x3<Scalar>& p, const BasicMatrix3x3<Scalar>& m) {
+  // p * m' = (m * p)' since p is symmetric.
+  const BasicMatrix3x3<Scalar> mp = Product(m, p);
+  return BasicMatrix3x3<Scalar>(mp(0, 0), mp(1, 0), mp(2, 0), mp(0, 1),
+                                mp(1, 1), mp(2, 1), mp(0, 2), mp(1, 2),
+                                mp(2, 2));
+}
+
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> JosephUpdateCovariance(
+    const BasicMatrix3x3<Scalar>& k, const BasicMatrix3x3<Scalar>& h,
+    const BasicSymmetricMatrix3x3<Scalar>& p,
+    const BasicSymmetricMatrix3x3<Scalar>& r) {
+  const BasicMatrix3x3<Scalar> i_kh =
+      BasicMatrix3x3<Scalar>::Identity() - k * h;
+  return SandwichProduct(i_kh, p) + SandwichProduct(k, r);
+}
+
+#define CARDBOARD_SDK_INSTANTIATE_SYMMETRIC_MATRIX_3X3(Scalar)                \
+  template class BasicSymmetricMatrix3x3<Scalar>;                             \
+  template BasicSymmetricMatrix3x3<Scalar> SandwichProduct(                   \
+      const BasicMatrix3x3<Scalar>& m,                                        \
+      const BasicSymmetricMatrix3x3<Scalar>& p);                              \
+  template BasicSymmetricMatrix3x3<Scalar> PredictCovariance(                 \
+      const BasicMatrix3x3<Scalar>& f,                                        \
+      const BasicSymmetricMatrix3x3<Scalar>& p, Scalar dt_squared,            \
+      const BasicSymmetricMatrix3x3<Scalar>& q);                              \
+  template BasicMatrix3x3<Scalar> ProductWithTranspose(                       \
+      const BasicSymmetricMatrix3x3<Scalar>& p,                               \
+      const BasicMatrix3x3<Scalar>& m);                                       \
+  template BasicSymmetricMatrix3x3<Scalar> JosephUpdateCovariance(            \
+      const BasicMatrix3x3<Scalar>& k, const BasicMatrix3x3<Scalar>& h,       \
+      const BasicSymmetricMatrix3x3<Scalar>& p,                               \
+      const BasicSymmetricMatrix3x3<Scalar>& r);
+
+CARDBOARD_SDK_INSTANTIATE_SYMMETRIC_MATRIX_3X3(double)
+CARDBOARD_SDK_INSTANTIATE_SYMMETRIC_MATRIX_3X3(float)
+
+#undef CARDBOARD_SDK_INSTANTIATE_SYMMETRIC_MATRIX_3X3
+
+}  // namespace cardboard
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CARDBOARD_SDK_UTIL_SYMMETRIC_MATRIX_3X3_H_
+#define CARDBOARD_SDK_UTIL_SYMMETRIC_MATRIX_3X3_H_
+
+#include <array>
+
+#include "util/matrix_3x3.h"
+
+namespace cardboard {
+
+// Symmetric 3x3 matrix storing only its 6 unique elements, as used for
+// covariances. The upper triangle is packed in row-major order:
+//
+//   | 0 1 2 |
+//   | . 3 4 |
+//   | . . 5 |
+//
+// Keeping a single copy of the off-diagonal elements makes the matrix
+// symmetric by construction, whatever the rounding of the operations on it.
+// Use the SymmetricMatrix3x3 (double) and SymmetricMatrix3x3f (float)
+// typedefs.
+template <typename Scalar>
+class BasicSymmetricMatrix3x3 {
+ public:
+  // The default constructor zero-initializes all elements.
+  BasicSymmetricMatrix3x3();
+
+  // Constructor that is passed the upper triangle elements.
+  BasicSymmetricMatrix3x3(Scalar m00, Scalar m01, Scalar m02, Scalar m11,
+                          Scalar m12, Scalar m22);
+
+  // Returns a SymmetricMatrix3x3 containing all zeroes.
+  static BasicSymmetricMatrix3x3 Zero();
+
+  // Returns an identity SymmetricMatrix3x3.
+  static BasicSymmetricMatrix3x3 Identity();
+
+  // Returns the symmetric part (m + m') / 2 of @p m.
+  static BasicSymmetricMatrix3x3 FromMatrix(const BasicMatrix3x3<Scalar>& m);
+
+  // Returns the full matrix.
+  BasicMatrix3x3<Scalar> ToMatrix() const;
+
+  // Read-only element accessor.
+  Scalar operator()(int row, int col) const { return elem_[Index(row, col)]; }
+
+  // Binary scale operators.
+  friend BasicSymmetricMatrix3x3 operator*(const BasicSymmetricMatrix3x3& m,
+                                           Scalar s) {
+    return Scale(m, s);
+  }
+  friend BasicSymmetricMatrix3x3 operator*(Scalar s,
+                                           const BasicSymmetricMatrix3x3& m) {
+    return Scale(m, s);
+  }
+
+  // Binary matrix addition.
+  friend BasicSymmetricMatrix3x3 operator+(
+      const BasicSymmetricMatrix3x3& lhs, const BasicSymmetricMatrix3x3& rhs) {
+    return Addition(lhs, rhs);
+  }
+
+ private:
+  // Returns the index in elem_ of the element at (row, col).
+  static int Index(int row, int col) {
+    static constexpr int kIndex[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+    return kIndex[row][col];
+  }
+
+  static BasicSymmetricMatrix3x3 Addition(const BasicSymmetricMatrix3x3& lhs,
+                                          const BasicSymmetricMatrix3x3& rhs);
+  static BasicSymmetricMatrix3x3 Scale(const BasicSymmetricMatrix3x3& m,
+                                       Scalar s);
+
+  std::array<Scalar, 6> elem_;
+};
+
+typedef BasicSymmetricMatrix3x3<double> SymmetricMatrix3x3;
+typedef BasicSymmetricMatrix3x3<float> SymmetricMatrix3x3f;
+
+extern template class BasicSymmetricMatrix3x3<double>;
+extern template class BasicSymmetricMatrix3x3<float>;
+
+// Returns m * p * m'.
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> SandwichProduct(
+    const BasicMatrix3x3<Scalar>& m, const BasicSymmetricMatrix3x3<Scalar>& p);
+
+// Returns the Kalman filter covariance prediction
+// f * p * f' + dt_squared * q, computing only the unique elements.
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> PredictCovariance(
+    const BasicMatrix3x3<Scalar>& f, const BasicSymmetricMatrix3x3<Scalar>& p,
+    Scalar dt_squared, const BasicSymmetricMatrix3x3<Scalar>& q);
+
+// Returns p * m'.
+template <typename Scalar>
+BasicMatrix3x3<Scalar> ProductWithTranspose(
+    const BasicSymmetricMatrix3x3<Scalar>& p, const BasicMatrix3x3<Scalar>& m);
+
+// Returns the Joseph form of the Kalman filter covariance update
+// (I - k * h) * p * (I - k * h)' + k * r * k', which stays symmetric positive
+// semi-definite even when k is not exactly the optimal gain.
+template <typename Scalar>
+BasicSymmetricMatrix3x3<Scalar> JosephUpdateCovariance(
+    const BasicMatrix3x3<Scalar>& k, const BasicMatrix3x3<Scalar>& h,
+    const BasicSymmetricMatrix3x3<Scalar>& p,
+    const BasicSymmetricMatrix3x3<Scalar>& r);
+
+}  // namespace cardboard
+
+#endif  // CARDBOARD_SDK_UTIL_SYMMETRIC_MATRIX_3X3_H_
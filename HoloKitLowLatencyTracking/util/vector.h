@@ -20,203 +20,228 @@
 
 namespace cardboard {
 
-// Geometric N-dimensional Vector class.
-template <int Dimension>
+// Geometric N-dimensional Vector class. All operations are constexpr so that
+// vectors can be compile-time constants.
+template <int Dimension, typename Scalar = double>
 class Vector {
  public:
   // The default constructor zero-initializes all elements.
-  Vector();
+  constexpr Vector();
 
   // Dimension-specific constructors that are passed individual element values.
-  constexpr Vector(double e0, double e1, double e2);
-  constexpr Vector(double e0, double e1, double e2, double e3);
+  constexpr Vector(Scalar e0, Scalar e1, Scalar e2);
+  constexpr Vector(Scalar e0, Scalar e1, Scalar e2, Scalar e3);
 
   // Constructor for a Vector of dimension N from a Vector of dimension N-1 and
   // a scalar of the correct type, assuming N is at least 2.
-  constexpr Vector(const Vector<Dimension - 1>& v, double s);
+  constexpr Vector(const Vector<Dimension - 1, Scalar>& v, Scalar s);
+
+  // Converts a Vector of another scalar type.
+  template <typename OtherScalar>
+  constexpr explicit Vector(const Vector<Dimension, OtherScalar>& v)
+      : elem_{} {
+    for (int i = 0; i < Dimension; i++) {
+      elem_[i] = static_cast<Scalar>(v[i]);
+    }
+  }
 
-  void Set(double e0, double e1, double e2);  // Only when Dimension == 3.
-  void Set(double e0, double e1, double e2,
-           double e3);  // Only when Dimension == 4.
+  // Only when Dimension == 3.
+  constexpr void Set(Scalar e0, Scalar e1, Scalar e2);
+  // Only when Dimension == 4.
+  constexpr void Set(Scalar e0, Scalar e1, Scalar e2, Scalar e3);
 
   // Mutable element accessor.
-  double& operator[](int index) { return elem_[index]; }
+  constexpr Scalar& operator[](int index) { return elem_[index]; }
 
   // Element accessor.
-  double operator[](int index) const { return elem_[index]; }
+  constexpr Scalar operator[](int index) const { return elem_[index]; }
+
+  // Return a pointer to the data for interfacing with libraries.
+  constexpr Scalar* Data() { return elem_.data(); }
+  constexpr const Scalar* Data() const { return elem_.data(); }
 
   // Returns a Vector containing all zeroes.
-  static Vector Zero();
+  static constexpr Vector Zero();
 
   // Self-modifying operators.
-  void operator+=(const Vector& v) { Add(v); }
-  void operator-=(const Vector& v) { Subtract(v); }
-  void operator*=(double s) { Multiply(s); }
-  void operator/=(double s) { Divide(s); }
+  constexpr void operator+=(const Vector& v) { Add(v); }
+  constexpr void operator-=(const Vector& v) { Subtract(v); }
+  constexpr void operator*=(Scalar s) { Multiply(s); }
+  constexpr void operator/=(Scalar s) { Divide(s); }
 
   // Unary negation operator.
-  Vector operator-() const { return Negation(); }
+  constexpr Vector operator-() const { return Negation(); }
 
   // Binary operators.
-  friend Vector operator+(const Vector& v0, const Vector& v1) {
+  friend constexpr Vector operator+(const Vector& v0, const Vector& v1) {
     return Sum(v0, v1);
   }
-  friend Vector operator-(const Vector& v0, const Vector& v1) {
+  friend constexpr Vector operator-(const Vector& v0, const Vector& v1) {
     return Difference(v0, v1);
   }
-  friend Vector operator*(const Vector& v, double s) { return Scale(v, s); }
-  friend Vector operator*(double s, const Vector& v) { return Scale(v, s); }
-  friend Vector operator*(const Vector& v, const Vector& s) {
+  friend constexpr Vector operator*(const Vector& v, Scalar s) {
+    return Scale(v, s);
+  }
+  friend constexpr Vector operator*(Scalar s, const Vector& v) {
+    return Scale(v, s);
+  }
+  friend constexpr Vector operator*(const Vector& v, const Vector& s) {
     return Product(v, s);
   }
-  friend Vector operator/(const Vector& v, double s) { return Divide(v, s); }
+  friend constexpr Vector operator/(const Vector& v, Scalar s) {
+    return Divide(v, s);
+  }
 
   // Self-modifying addition.
-  void Add(const Vector& v);
+  constexpr void Add(const Vector& v);
   // Self-modifying subtraction.
-  void Subtract(const Vector& v);
+  constexpr void Subtract(const Vector& v);
   // Self-modifying multiplication by a scalar.
-  void Multiply(double s);
+  constexpr void Multiply(Scalar s);
   // Self-modifying division by a scalar.
-  void Divide(double s);
+  constexpr void Divide(Scalar s);
 
   // Unary negation.
-  Vector Negation() const;
+  constexpr Vector Negation() const;
 
   // Binary component-wise multiplication.
-  static Vector Product(const Vector& v0, const Vector& v1);
+  static constexpr Vector Product(const Vector& v0, const Vector& v1);
   // Binary component-wise addition.
-  static Vector Sum(const Vector& v0, const Vector& v1);
+  static constexpr Vector Sum(const Vector& v0, const Vector& v1);
   // Binary component-wise subtraction.
-  static Vector Difference(const Vector& v0, const Vector& v1);
+  static constexpr Vector Difference(const Vector& v0, const Vector& v1);
   // Binary multiplication by a scalar.
-  static Vector Scale(const Vector& v, double s);
+  static constexpr Vector Scale(const Vector& v, Scalar s);
   // Binary division by a scalar.
-  static Vector Divide(const Vector& v, double s);
+  static constexpr Vector Divide(const Vector& v, Scalar s);
 
  private:
-  std::array<double, Dimension> elem_;
+  std::array<Scalar, Dimension> elem_;
 };
 //------------------------------------------------------------------------------
 
-template <int Dimension>
-Vector<Dimension>::Vector() {
-  for (int i = 0; i < Dimension; i++) {
-    elem_[i] = 0;
-  }
-}
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar>::Vector() : elem_{} {}
 
-template <int Dimension>
-constexpr Vector<Dimension>::Vector(double e0, double e1, double e2)
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar>::Vector(Scalar e0, Scalar e1, Scalar e2)
     : elem_{e0, e1, e2} {}
 
-template <int Dimension>
-constexpr Vector<Dimension>::Vector(double e0, double e1, double e2, double e3)
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar>::Vector(Scalar e0, Scalar e1, Scalar e2,
+                                            Scalar e3)
     : elem_{e0, e1, e2, e3} {}
 
-template <>
-constexpr Vector<4>::Vector(const Vector<3>& v, double s)
-    : elem_{v[0], v[1], v[2], s} {}
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar>::Vector(
+    const Vector<Dimension - 1, Scalar>& v, Scalar s)
+    : elem_{v[0], v[1], v[2], s} {
+  static_assert(Dimension == 4, "Only defined for Dimension == 4.");
+}
 
-template <int Dimension>
-void Vector<Dimension>::Set(double e0, double e1, double e2) {
+template <int Dimension, typename Scalar>
+constexpr void Vector<Dimension, Scalar>::Set(Scalar e0, Scalar e1, Scalar e2) {
   elem_[0] = e0;
   elem_[1] = e1;
   elem_[2] = e2;
 }
 
-template <int Dimension>
-void Vector<Dimension>::Set(double e0, double e1, double e2, double e3) {
+template <int Dimension, typename Scalar>
+constexpr void Vector<Dimension, Scalar>::Set(Scalar e0, Scalar e1, Scalar e2,
+                                              Scalar e3) {
   elem_[0] = e0;
   elem_[1] = e1;
   elem_[2] = e2;
   elem_[3] = e3;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Zero() {
-  Vector<Dimension> v;
-  return v;
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar> Vector<Dimension, Scalar>::Zero() {
+  return Vector<Dimension, Scalar>();
 }
 
-template <int Dimension>
-void Vector<Dimension>::Add(const Vector& v) {
+template <int Dimension, typename Scalar>
+constexpr void Vector<Dimension, Scalar>::Add(const Vector& v) {
   for (int i = 0; i < Dimension; i++) {
     elem_[i] += v[i];
   }
 }
 
-template <int Dimension>
-void Vector<Dimension>::Subtract(const Vector& v) {
+template <int Dimension, typename Scalar>
+constexpr void Vector<Dimension, Scalar>::Subtract(const Vector& v) {
   for (int i = 0; i < Dimension; i++) {
     elem_[i] -= v[i];
   }
 }
 
-template <int Dimension>
-void Vector<Dimension>::Multiply(double s) {
+template <int Dimension, typename Scalar>
+constexpr void Vector<Dimension, Scalar>::Multiply(Scalar s) {
   for (int i = 0; i < Dimension; i++) {
     elem_[i] *= s;
   }
 }
 
-template <int Dimension>
-void Vector<Dimension>::Divide(double s) {
+template <int Dimension, typename Scalar>
+constexpr void Vector<Dimension, Scalar>::Divide(Scalar s) {
   for (int i = 0; i < Dimension; i++) {
     elem_[i] /= s;
   }
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Negation() const {
-  Vector<Dimension> ret;
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar> Vector<Dimension, Scalar>::Negation()
+    const {
+  Vector<Dimension, Scalar> ret;
   for (int i = 0; i < Dimension; i++) {
     ret.elem_[i] = -elem_[i];
   }
   return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Product(const Vector& v0,
-                                             const Vector& v1) {
-  Vector<Dimension> ret;
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar> Vector<Dimension, Scalar>::Product(
+    const Vector& v0, const Vector& v1) {
+  Vector<Dimension, Scalar> ret;
   for (int i = 0; i < Dimension; i++) {
     ret.elem_[i] = v0[i] * v1[i];
   }
   return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Sum(const Vector& v0, const Vector& v1) {
-  Vector<Dimension> ret;
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar> Vector<Dimension, Scalar>::Sum(
+    const Vector& v0, const Vector& v1) {
+  Vector<Dimension, Scalar> ret;
   for (int i = 0; i < Dimension; i++) {
     ret.elem_[i] = v0[i] + v1[i];
   }
   return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Difference(const Vector& v0,
-                                                const Vector& v1) {
-  Vector<Dimension> ret;
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar> Vector<Dimension, Scalar>::Difference(
+    const Vector& v0, const Vector& v1) {
+  Vector<Dimension, Scalar> ret;
   for (int i = 0; i < Dimension; i++) {
     ret.elem_[i] = v0[i] - v1[i];
   }
   return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Scale(const Vector& v, double s) {
-  Vector<Dimension> ret;
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar> Vector<Dimension, Scalar>::Scale(
+    const Vector& v, Scalar s) {
+  Vector<Dimension, Scalar> ret;
   for (int i = 0; i < Dimension; i++) {
     ret.elem_[i] = v[i] * s;
   }
   return ret;
 }
 
-template <int Dimension>
-Vector<Dimension> Vector<Dimension>::Divide(const Vector& v, double s) {
-  Vector<Dimension> ret;
+template <int Dimension, typename Scalar>
+constexpr Vector<Dimension, Scalar> Vector<Dimension, Scalar>::Divide(
+    const Vector& v, Scalar s) {
+  Vector<Dimension, Scalar> ret;
   for (int i = 0; i < Dimension; i++) {
     ret.elem_[i] = v[i] / s;
   }
@@ -225,6 +250,8 @@ Vector<Dimension> Vector<Dimension>::Divide(const Vector& v, double s) {
 
 typedef Vector<3> Vector3;
 typedef Vector<4> Vector4;
+typedef Vector<3, float> Vector3f;
+typedef Vector<4, float> Vector4f;
 
 }  // namespace cardboard
 
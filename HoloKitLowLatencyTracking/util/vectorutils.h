@@ -27,31 +27,35 @@
 namespace cardboard {
 
 // Returns the dot (inner) product of two Vectors.
-double Dot(const Vector<3>& v0, const Vector<3>& v1);
+template <typename Scalar>
+Scalar Dot(const Vector<3, Scalar>& v0, const Vector<3, Scalar>& v1);
 
 // Returns the dot (inner) product of two Vectors.
-double Dot(const Vector<4>& v0, const Vector<4>& v1);
+template <typename Scalar>
+Scalar Dot(const Vector<4, Scalar>& v0, const Vector<4, Scalar>& v1);
 
 // Returns the 3-dimensional cross product of 2 Vectors. Note that this is
 // defined only for 3-dimensional Vectors.
-Vector<3> Cross(const Vector<3>& v0, const Vector<3>& v1);
+template <typename Scalar>
+Vector<3, Scalar> Cross(const Vector<3, Scalar>& v0,
+                        const Vector<3, Scalar>& v1);
 
 // Returns the square of the length of a Vector.
-template <int Dimension>
-double LengthSquared(const Vector<Dimension>& v) {
+template <int Dimension, typename Scalar>
+Scalar LengthSquared(const Vector<Dimension, Scalar>& v) {
   return Dot(v, v);
 }
 
 // Returns the geometric length of a Vector.
-template <int Dimension>
-double Length(const Vector<Dimension>& v) {
-  return sqrt(LengthSquared(v));
+template <int Dimension, typename Scalar>
+Scalar Length(const Vector<Dimension, Scalar>& v) {
+  return std::sqrt(LengthSquared(v));
 }
 
 // the Vector untouched and returns false.
-template <int Dimension>
-bool Normalize(Vector<Dimension>* v) {
-  const double len = Length(*v);
+template <int Dimension, typename Scalar>
+bool Normalize(Vector<Dimension, Scalar>* v) {
+  const Scalar len = Length(*v);
   if (len == 0) {
     return false;
   } else {
@@ -62,13 +66,13 @@ bool Normalize(Vector<Dimension>* v) {
 
 // Returns a unit-length version of a Vector. If the given Vector has no
 // length, this returns a Zero() Vector.
-template <int Dimension>
-Vector<Dimension> Normalized(const Vector<Dimension>& v) {
-  Vector<Dimension> result = v;
+template <int Dimension, typename Scalar>
+Vector<Dimension, Scalar> Normalized(const Vector<Dimension, Scalar>& v) {
+  Vector<Dimension, Scalar> result = v;
   if (Normalize(&result))
     return result;
   else
-    return Vector<Dimension>::Zero();
+    return Vector<Dimension, Scalar>::Zero();
 }
 
 }  // namespace cardboard
@@ -0,0 +1,525 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Microbenchmarks for the per-sample and per-frame paths of the tracker.
+//
+// Every benchmark times one operation in isolation on synthetic but
+// realistic head motion (see synthetic_motion.h), so numbers can be compared
+// from one commit to the next on the same machine. Operations are timed in
+// batches; the reported percentiles are over the per-operation time of each
+// batch.
+//
+// Usage:
+//   holokit_fusion_benchmark [--filter=<substring>] [--batches=<n>]
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "head_tracker.h"
+#include "sensors/gyroscope_bias_estimator.h"
+#include "sensors/linux/trace_player.h"
+#include "sensors/mean_filter.h"
+#include "sensors/median_filter.h"
+#include "sensors/sensor_fusion_ekf.h"
+#include "sensors/sensor_fusion_replay.h"
+#include "sixdof/position_data.h"
+#include "sixdof/position_kalman_filter.h"
+#include "sixdof/time_offset_estimator.h"
+#include "util/matrixutils.h"
+#include "util/vectorutils.h"
+#include "synthetic_motion.h"
+
+namespace {
+
+std::atomic<uint64_t> allocation_count(0);
+
+}  // namespace
+
+// Counts heap allocations so that allocations per operation can be reported.
+void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+namespace cardboard::benchmarks {
+
+namespace {
+
+constexpr int kBatchSize = 64;
+constexpr int kWarmupBatches = 50;
+constexpr int64_t kStartTimestampNs = 1000000000;
+constexpr int64_t kPredictionNs = 50000000;
+
+// Prevents the compiler from optimizing away a computed value.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Options {
+  std::string filter;
+  int batches = 2000;
+};
+
+struct Result {
+  double ns_per_op;
+  double p50_ns;
+  double p99_ns;
+  double allocations_per_op;
+};
+
+// Runs @p op kBatchSize times per batch. @p op receives the index of the
+// operation, counting from zero across warmup and measured batches.
+// @p between_batches runs outside of the timed region.
+template <typename Op, typename BetweenBatches>
+Result Run(const Options& options, Op&& op, BetweenBatches&& between_batches) {
+  using Clock = std::chrono::steady_clock;
+  int64_t index = 0;
+  for (int batch = 0; batch < kWarmupBatches; ++batch) {
+    for (int i = 0; i < kBatchSize; ++i) {
+      op(index++);
+    }
+    between_batches();
+  }
+
+  std::vector<double> batch_ns_per_op;
+  batch_ns_per_op.reserve(options.batches);
+  double total_ns = 0;
+  uint64_t allocations = 0;
+  for (int batch = 0; batch < options.batches; ++batch) {
+    const uint64_t allocations_before =
+        allocation_count.load(std::memory_order_relaxed);
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < kBatchSize; ++i) {
+      op(index++);
+    }
+    const Clock::time_point end = Clock::now();
+    allocations +=
+        allocation_count.load(std::memory_order_relaxed) - allocations_before;
+    const double batch_ns =
+        std::chrono::duration<double, std::nano>(end - start).count();
+    total_ns += batch_ns;
+    batch_ns_per_op.push_back(batch_ns / kBatchSize);
+    between_batches();
+  }
+
+  std::sort(batch_ns_per_op.begin(), batch_ns_per_op.end());
+  const double ops = static_cast<double>(options.batches) * kBatchSize;
+  const auto percentile = [&batch_ns_per_op](double p) {
+    return batch_ns_per_op[static_cast<size_t>(
+        p * static_cast<double>(batch_ns_per_op.size() - 1))];
+  };
+  return {total_ns / ops, percentile(0.5), percentile(0.99),
+          static_cast<double>(allocations) / ops};
+}
+
+template <typename Op>
+Result Run(const Options& options, Op&& op) {
+  return Run(options, op, [] {});
+}
+
+// Total number of operations run by Run(), warmup included.
+int64_t GetOperationCount(const Options& options) {
+  return static_cast<int64_t>(kWarmupBatches + options.batches) * kBatchSize;
+}
+
+std::vector<AccelerometerData> MakeAccelerometerSamples(
+    SyntheticMotion::Profile profile, int64_t count) {
+  SyntheticMotion motion(profile);
+  std::vector<AccelerometerData> samples;
+  samples.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    samples.push_back(motion.GetAccelerometerSample(
+        kStartTimestampNs + i * SyntheticMotion::kImuPeriodNs));
+  }
+  return samples;
+}
+
+std::vector<GyroscopeData> MakeGyroscopeSamples(
+    SyntheticMotion::Profile profile, int64_t count) {
+  SyntheticMotion motion(profile);
+  std::vector<GyroscopeData> samples;
+  samples.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    samples.push_back(motion.GetGyroscopeSample(
+        kStartTimestampNs + i * SyntheticMotion::kImuPeriodNs));
+  }
+  return samples;
+}
+
+// Feeds one second of interleaved IMU samples to @p sensor_fusion and returns
+// the timestamp of the last one.
+template <typename SensorFusion>
+int64_t PrimeSensorFusion(SensorFusion* sensor_fusion) {
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  int64_t t = kStartTimestampNs;
+  for (int i = 0; i < 100; ++i, t += SyntheticMotion::kImuPeriodNs) {
+    sensor_fusion->ProcessAccelerometerSample(motion.GetAccelerometerSample(t));
+    sensor_fusion->ProcessGyroscopeSample(motion.GetGyroscopeSample(t));
+  }
+  return t - SyntheticMotion::kImuPeriodNs;
+}
+
+// The sensor fusion benchmarks are run for both the double and the float
+// engines.
+template <typename SensorFusion>
+Result BenchmarkProcessGyroscopeSample(const Options& options) {
+  const std::vector<GyroscopeData> samples = MakeGyroscopeSamples(
+      SyntheticMotion::Profile::kLookingAround, GetOperationCount(options));
+  SensorFusion sensor_fusion;
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  // Gyroscope samples are only integrated once aligned with gravity.
+  sensor_fusion.ProcessAccelerometerSample(
+      motion.GetAccelerometerSample(kStartTimestampNs - 1));
+  return Run(options, [&](int64_t i) {
+    sensor_fusion.ProcessGyroscopeSample(samples[i]);
+  });
+}
+
+template <typename SensorFusion>
+Result BenchmarkProcessAccelerometerSample(const Options& options) {
+  const std::vector<AccelerometerData> samples = MakeAccelerometerSamples(
+      SyntheticMotion::Profile::kLookingAround, GetOperationCount(options));
+  SensorFusion sensor_fusion;
+  return Run(options, [&](int64_t i) {
+    sensor_fusion.ProcessAccelerometerSample(samples[i]);
+  });
+}
+
+template <typename SensorFusion>
+Result BenchmarkPredictRotation(const Options& options) {
+  SensorFusion sensor_fusion;
+  const int64_t timestamp_ns = PrimeSensorFusion(&sensor_fusion);
+  return Run(options, [&](int64_t i) {
+    DoNotOptimize(sensor_fusion.PredictRotation(timestamp_ns + kPredictionNs +
+                                                (i & 1023) * 1000));
+  });
+}
+
+// Applies a rotation measurement close to the estimate, as the head tracker
+// does with every 6DoF orientation.
+Result BenchmarkProcessRotationMeasurement(const Options& options) {
+  SensorFusionEkf sensor_fusion;
+  const int64_t timestamp_ns = PrimeSensorFusion(&sensor_fusion);
+  const Rotation rotation =
+      Rotation::Cast(sensor_fusion.PredictRotation(timestamp_ns));
+  return Run(options, [&](int64_t i) {
+    sensor_fusion.ProcessRotationMeasurement(rotation,
+                                             timestamp_ns + (i & 7));
+  });
+}
+
+// Processes the gyroscope samples through the replay buffer, which records
+// them and saves a checkpoint of the filter every eighth sample.
+Result BenchmarkReplayProcessGyroscopeSample(const Options& options) {
+  const std::vector<GyroscopeData> samples = MakeGyroscopeSamples(
+      SyntheticMotion::Profile::kLookingAround, GetOperationCount(options));
+  SensorFusionEkf sensor_fusion;
+  SensorFusionReplay<SensorFusionEkf> replay(&sensor_fusion, 128, 8);
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  replay.ProcessAccelerometerSample(
+      motion.GetAccelerometerSample(kStartTimestampNs - 1));
+  return Run(options,
+             [&](int64_t i) { replay.ProcessGyroscopeSample(samples[i]); });
+}
+
+// Applies a rotation captured @p kLatencyNs before the latest IMU sample, as
+// the head tracker does with the 6DoF orientations: the filter is rewound to
+// the checkpoint before it and the samples since are replayed.
+template <int64_t kLatencyNs>
+Result BenchmarkReplayApplyRotationMeasurement(const Options& options) {
+  SensorFusionEkf sensor_fusion;
+  SensorFusionReplay<SensorFusionEkf> replay(&sensor_fusion, 128, 8);
+  const int64_t timestamp_ns = PrimeSensorFusion(&replay);
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  const Rotation rotation =
+      motion.GetSensorFromStartRotation(timestamp_ns - kLatencyNs);
+  return Run(options, [&](int64_t i) {
+    replay.ApplyRotationMeasurement(rotation,
+                                    timestamp_ns - kLatencyNs + (i & 7));
+  });
+}
+
+Result BenchmarkBiasEstimatorProcessAccelerometer(const Options& options) {
+  const std::vector<AccelerometerData> samples = MakeAccelerometerSamples(
+      SyntheticMotion::Profile::kStill, GetOperationCount(options));
+  GyroscopeBiasEstimator estimator;
+  return Run(options, [&](int64_t i) {
+    estimator.ProcessAccelerometer(samples[i].data,
+                                   samples[i].sensor_timestamp_ns);
+  });
+}
+
+// Evaluates the Kalman gain and covariance update chains written with the
+// operator syntax, on matrices taken from a running filter.
+Result BenchmarkMatrixChain(const Options& options) {
+  const Matrix3x3 p(2e-3, 1e-4, -2e-4, 1e-4, 3e-3, 5e-5, -2e-4, 5e-5, 1e-3);
+  const Matrix3x3 h = SkewSymmetric(Vector3(0.1, -0.2, 0.97));
+  const Matrix3x3 r = Matrix3x3::Identity() * 0.25;
+  Matrix3x3 k;
+  return Run(options, [&](int64_t i) {
+    const Matrix3x3 s = h * p * Transpose(h) + r * (1.0 + (i & 1));
+    k = p * Transpose(h) * Inverse(s);
+    const Matrix3x3 i_kh = Matrix3x3::Identity() - k * h;
+    DoNotOptimize(i_kh * p * Transpose(i_kh) + k * r * Transpose(k));
+  });
+}
+
+Result BenchmarkMedianFilter(const Options& options) {
+  const std::vector<AccelerometerData> samples = MakeAccelerometerSamples(
+      SyntheticMotion::Profile::kStill, kWarmupBatches + options.batches + 5);
+  MedianFilter filter(5);
+  size_t next_sample = 0;
+  while (!filter.IsValid()) {
+    filter.AddSample(samples[next_sample++].data);
+  }
+  return Run(
+      options, [&](int64_t) { DoNotOptimize(filter.GetFilteredData()); },
+      [&] { filter.AddSample(samples[next_sample++].data); });
+}
+
+// Uses a window much larger than the bias estimator's to show that the cost
+// does not grow with the window size.
+Result BenchmarkMeanFilter(const Options& options) {
+  constexpr int kWindowSize = 500;
+  const std::vector<AccelerometerData> samples = MakeAccelerometerSamples(
+      SyntheticMotion::Profile::kStill, kWindowSize);
+  MeanFilter filter(kWindowSize);
+  return Run(options, [&](int64_t i) {
+    filter.AddSample(samples[i % kWindowSize].data);
+    DoNotOptimize(filter.GetFilteredData());
+  });
+}
+
+Result BenchmarkPositionDataExtrapolation(const Options& options) {
+  constexpr int kSamples = 6;
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  PositionData position_data(kSamples);
+  int64_t t = kStartTimestampNs;
+  for (int i = 0; i < kSamples; ++i, t += SyntheticMotion::kSixDoFPeriodNs) {
+    position_data.AddSample(motion.GetPosition(t), t);
+  }
+  return Run(options, [&](int64_t i) {
+    DoNotOptimize(
+        position_data.GetExtrapolatedForTimeStamp(t + (i & 63) * 1000000));
+  });
+}
+
+template <PositionData::Model kModel>
+Result BenchmarkPositionDataAddSample(const Options& options) {
+  constexpr int kSamples = 6;
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  PositionData position_data(kSamples);
+  position_data.SetModel(kModel);
+  return Run(options, [&](int64_t i) {
+    const int64_t t = kStartTimestampNs + i * SyntheticMotion::kSixDoFPeriodNs;
+    position_data.AddSample(Vector3(1e-3 * static_cast<double>(i & 63), 0, 0),
+                            t);
+  });
+}
+
+// Integrates accelerometer samples at 100 Hz, and every other sample applies a
+// position captured 50 ms earlier, which rewinds the filter by five samples.
+Result BenchmarkPositionKalmanFilter(const Options& options) {
+  constexpr int64_t kLatencyNs = 50000000;
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  PositionKalmanFilter filter;
+  filter.AddPosition(kStartTimestampNs - kLatencyNs,
+                     motion.GetPosition(kStartTimestampNs - kLatencyNs));
+  return Run(options, [&](int64_t i) {
+    const int64_t t = kStartTimestampNs + i * SyntheticMotion::kImuPeriodNs;
+    filter.AddAcceleration(t, Vector3(0.1, -0.05, 0.02));
+    if (i & 1) {
+      filter.AddPosition(t - kLatencyNs, motion.GetPosition(t - kLatencyNs));
+    }
+  });
+}
+
+Result BenchmarkTimeOffsetEstimator(const Options& options) {
+  // Ten seconds of 6DoF orientations, with two EKF angular speeds per 6DoF
+  // sample, replayed in a loop with increasing timestamps. Every 30th
+  // operation cross-correlates the buffered samples.
+  constexpr int64_t kSamples = 600;
+  constexpr int64_t kPeriodNs = SyntheticMotion::kSixDoFPeriodNs;
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  std::vector<Rotation> orientations;
+  std::vector<double> angular_speeds;
+  for (int64_t i = 0; i < kSamples; ++i) {
+    const int64_t t = kStartTimestampNs + i * kPeriodNs;
+    orientations.push_back(-motion.GetSensorFromStartRotation(t));
+    for (const int64_t imu_t : {t - kPeriodNs / 2, t}) {
+      const Rotation step = motion.GetSensorFromStartRotation(imu_t + 1000000) *
+                            -motion.GetSensorFromStartRotation(imu_t);
+      angular_speeds.push_back(Length(step.Log()) / 1e-3);
+    }
+  }
+  SixDoFTimeOffsetEstimator estimator;
+  return Run(options, [&](int64_t i) {
+    const int64_t sample = i % kSamples;
+    const int64_t t = kStartTimestampNs + i * kPeriodNs;
+    estimator.AddAngularSpeed(t - kPeriodNs / 2, angular_speeds[2 * sample]);
+    estimator.AddAngularSpeed(t, angular_speeds[2 * sample + 1]);
+    estimator.AddSixDoFOrientation(t, orientations[sample]);
+  });
+}
+
+Result BenchmarkGetPose(const Options& options) {
+  // Drive the tracker through the trace backend so that it holds the state of
+  // a real session, 6DoF history included.
+  SyntheticMotion motion(SyntheticMotion::Profile::kLookingAround);
+  constexpr int64_t kTraceDurationNs = 2000000000;
+  std::shared_ptr<const SensorTrace> trace =
+      motion.MakeTrace(kStartTimestampNs, kTraceDurationNs);
+  TracePlayer::SetTrace(trace, 0);
+
+  HeadTracker head_tracker;
+  SensorEventProducer<SixDoFData> sixdof_producer;
+  const std::function<void(SixDoFData)> on_sixdof_callback =
+      [&head_tracker](SixDoFData event) {
+        head_tracker.AddSixDoFData(
+            static_cast<int64_t>(event.sensor_timestamp_ns),
+            event.position.data(), event.orientation.data());
+      };
+  head_tracker.Resume();
+  sixdof_producer.StartSensorPolling(&on_sixdof_callback);
+  TracePlayer::Start();
+  while (!TracePlayer::IsFinished()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  std::array<float, 3> position;
+  std::array<float, 4> orientation;
+  const int64_t timestamp_ns = trace->GetEndTimestamp() + kPredictionNs;
+  const Result result = Run(options, [&](int64_t) {
+    head_tracker.GetPose(timestamp_ns, kLandscapeLeft, position, orientation);
+    DoNotOptimize(position);
+    DoNotOptimize(orientation);
+  });
+
+  sixdof_producer.StopSensorPolling();
+  head_tracker.Pause();
+  TracePlayer::SetTrace(nullptr, 0);
+  return result;
+}
+
+struct Benchmark {
+  const char* name;
+  Result (*function)(const Options& options);
+};
+
+constexpr Benchmark kBenchmarks[] = {
+    {"SensorFusionEkf::ProcessGyroscopeSample",
+     BenchmarkProcessGyroscopeSample<SensorFusionEkf>},
+    {"SensorFusionEkf::ProcessAccelerometerSample",
+     BenchmarkProcessAccelerometerSample<SensorFusionEkf>},
+    {"SensorFusionEkf::PredictRotation",
+     BenchmarkPredictRotation<SensorFusionEkf>},
+    {"SensorFusionEkf::ProcessRotationMeasurement",
+     BenchmarkProcessRotationMeasurement},
+    {"FloatSensorFusionEkf::ProcessGyroscopeSample",
+     BenchmarkProcessGyroscopeSample<FloatSensorFusionEkf>},
+    {"FloatSensorFusionEkf::ProcessAccelerometerSample",
+     BenchmarkProcessAccelerometerSample<FloatSensorFusionEkf>},
+    {"FloatSensorFusionEkf::PredictRotation",
+     BenchmarkPredictRotation<FloatSensorFusionEkf>},
+    {"SensorFusionReplay::ProcessGyroscopeSample",
+     BenchmarkReplayProcessGyroscopeSample},
+    {"SensorFusionReplay::ApplyRotationMeasurement (50 ms)",
+     BenchmarkReplayApplyRotationMeasurement<50000000>},
+    {"SensorFusionReplay::ApplyRotationMeasurement (500 ms)",
+     BenchmarkReplayApplyRotationMeasurement<500000000>},
+    {"GyroscopeBiasEstimator::ProcessAccelerometer",
+     BenchmarkBiasEstimatorProcessAccelerometer},
+    {"Matrix3x3 Kalman gain and update chain", BenchmarkMatrixChain},
+    {"MedianFilter::GetFilteredData", BenchmarkMedianFilter},
+    {"MeanFilter::AddSample+GetFilteredData (500)", BenchmarkMeanFilter},
+    {"PositionData::GetExtrapolatedForTimeStamp",
+     BenchmarkPositionDataExtrapolation},
+    {"PositionData::AddSample (constant velocity)",
+     BenchmarkPositionDataAddSample<PositionData::Model::kConstantVelocity>},
+    {"PositionData::AddSample (constant acceleration)",
+     BenchmarkPositionDataAddSample<
+         PositionData::Model::kConstantAcceleration>},
+    {"PositionKalmanFilter per accelerometer sample",
+     BenchmarkPositionKalmanFilter},
+    {"SixDoFTimeOffsetEstimator per 6DoF sample",
+     BenchmarkTimeOffsetEstimator},
+    {"HeadTracker::GetPose", BenchmarkGetPose},
+};
+
+// Returns the value of a "--name=value" argument, or nullptr.
+const char* GetFlagValue(const char* arg, const char* name) {
+  const size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) == 0 && arg[length] == '=') {
+    return arg + length + 1;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+}  // namespace cardboard::benchmarks
+
+int main(int argc, char** argv) {
+  using cardboard::benchmarks::kBenchmarks;
+  cardboard::benchmarks::Options options;
+  for (int i = 1; i < argc; ++i) {
+    using cardboard::benchmarks::GetFlagValue;
+    if (const char* value = GetFlagValue(argv[i], "--filter")) {
+      options.filter = value;
+    } else if (const char* value = GetFlagValue(argv[i], "--batches")) {
+      options.batches = std::max(1, std::atoi(value));
+    } else {
+      std::fprintf(stderr,
+                   "Usage: holokit_fusion_benchmark [--filter=<substring>] "
+                   "[--batches=<n>]\n");
+      return 1;
+    }
+  }
+
+  std::printf("%-50s %10s %10s %10s %10s\n", "benchmark", "ns/op", "p50",
+              "p99", "allocs/op");
+  for (const auto& benchmark : kBenchmarks) {
+    if (!options.filter.empty() &&
+        std::strstr(benchmark.name, options.filter.c_str()) == nullptr) {
+      continue;
+    }
+    const cardboard::benchmarks::Result result = benchmark.function(options);
+    std::printf("%-50s %10.1f %10.1f %10.1f %10.2f\n", benchmark.name,
+                result.ns_per_op, result.p50_ns, result.p99_ns,
+                result.allocations_per_op);
+    std::fflush(stdout);
+  }
+  return 0;
+}
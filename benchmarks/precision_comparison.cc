@@ -0,0 +1,281 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Compares the single and double precision sensor fusion engines.
+//
+// Both engines are fed the same IMU samples, in timestamp order and on the
+// calling thread, so that the comparison is deterministic. After every
+// gyroscope sample the tool records the angle between the rotations estimated
+// by the two engines, both for the current state and for a prediction
+// kPredictionNs ahead. On synthetic motion it also records the tilt error of
+// each engine, i.e. the angle between the estimated and true down directions
+// (the heading is not observable from the accelerometer), and that of a double
+// precision engine estimating the gyroscope bias as a filter state.
+//
+// With --check-jacobian, both engines also compare every analytic
+// accelerometer measurement Jacobian with a numerical one, and the tool fails
+// if they differ by more than the tolerance of the cross-check.
+//
+// Usage:
+//   holokit_fusion_precision [<trace>] [--duration-s=<s>] [--check-jacobian]
+//
+// Without a trace, synthetic traces of --duration-s seconds (default 600) are
+// generated for every motion profile.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "sensors/sensor_fusion_ekf.h"
+#include "sensors/sensor_trace.h"
+#include "synthetic_motion.h"
+#include "util/rotation.h"
+#include "util/vectorutils.h"
+
+namespace cardboard::benchmarks {
+
+namespace {
+
+constexpr int64_t kStartTimestampNs = 1000000000;
+constexpr int64_t kPredictionNs = 50000000;
+constexpr double kRadiansToMicroradians = 1e6;
+
+// Maximum and root mean square of a series of angles.
+class AngleStatistics {
+ public:
+  void Add(double angle) {
+    max_ = std::max(max_, angle);
+    sum_of_squares_ += angle * angle;
+    ++count_;
+  }
+
+  double GetMax() const { return max_; }
+  double GetRms() const {
+    return count_ == 0 ? 0 : std::sqrt(sum_of_squares_ / count_);
+  }
+
+ private:
+  double max_ = 0;
+  double sum_of_squares_ = 0;
+  int64_t count_ = 0;
+};
+
+struct Comparison {
+  AngleStatistics current_difference;
+  AngleStatistics predicted_difference;
+  AngleStatistics double_tilt_error;
+  AngleStatistics float_tilt_error;
+  AngleStatistics bias_state_tilt_error;
+  // Largest measurement Jacobian errors, when the cross-check is enabled.
+  double double_jacobian_error = 0;
+  double float_jacobian_error = 0;
+};
+
+// Returns the angle of the rotation between @p a and @p b in radians.
+double GetAngleBetween(const Rotation& a, const Rotation& b) {
+  const Vector4 q = (-a * b).GetQuaternion();
+  return 2 * std::atan2(Length(Vector3(q[0], q[1], q[2])), std::abs(q[3]));
+}
+
+// Returns the angle between the down directions of @p a and @p b in radians.
+double GetTiltAngleBetween(const Rotation& a, const Rotation& b) {
+  const Vector3 z(0, 0, 1);
+  const Vector3 a_down = a * z;
+  const Vector3 b_down = b * z;
+  return std::atan2(Length(Cross(a_down, b_down)), Dot(a_down, b_down));
+}
+
+// Replays @p trace through both engines. @p motion, if not null, provides the
+// ground truth of a synthetic trace. @p check_jacobian enables the
+// measurement Jacobian cross-check of both engines.
+Comparison Compare(const SensorTrace& trace, const SyntheticMotion* motion,
+                   bool check_jacobian) {
+  SensorFusionEkf double_fusion;
+  FloatSensorFusionEkf float_fusion;
+  double_fusion.SetMeasurementJacobianCheckEnabled(check_jacobian);
+  float_fusion.SetMeasurementJacobianCheckEnabled(check_jacobian);
+  SensorFusionEkf bias_state_fusion;
+  bias_state_fusion.SetGyroscopeBiasEstimation(
+      GyroscopeBiasEstimation::kFilterState);
+  Comparison comparison;
+
+  const std::vector<AccelerometerData>& accelerometer_samples =
+      trace.GetAccelerometerSamples();
+  const std::vector<GyroscopeData>& gyroscope_samples =
+      trace.GetGyroscopeSamples();
+  size_t next_accelerometer = 0;
+  for (const GyroscopeData& gyroscope_sample : gyroscope_samples) {
+    while (next_accelerometer < accelerometer_samples.size() &&
+           accelerometer_samples[next_accelerometer].sensor_timestamp_ns <=
+               gyroscope_sample.sensor_timestamp_ns) {
+      double_fusion.ProcessAccelerometerSample(
+          accelerometer_samples[next_accelerometer]);
+      float_fusion.ProcessAccelerometerSample(
+          accelerometer_samples[next_accelerometer]);
+      bias_state_fusion.ProcessAccelerometerSample(
+          accelerometer_samples[next_accelerometer]);
+      ++next_accelerometer;
+    }
+    double_fusion.ProcessGyroscopeSample(gyroscope_sample);
+    float_fusion.ProcessGyroscopeSample(gyroscope_sample);
+    bias_state_fusion.ProcessGyroscopeSample(gyroscope_sample);
+
+    const Rotation double_rotation =
+        double_fusion.GetLatestRotationState().sensor_from_start_rotation;
+    const Rotation float_rotation = Rotation::Cast(
+        float_fusion.GetLatestRotationState().sensor_from_start_rotation);
+    comparison.current_difference.Add(
+        GetAngleBetween(double_rotation, float_rotation));
+
+    const int64_t prediction_timestamp =
+        gyroscope_sample.system_timestamp + kPredictionNs;
+    comparison.predicted_difference.Add(GetAngleBetween(
+        double_fusion.PredictRotation(prediction_timestamp),
+        Rotation::Cast(float_fusion.PredictRotation(prediction_timestamp))));
+
+    if (motion != nullptr) {
+      const Rotation truth = motion->GetSensorFromStartRotation(
+          static_cast<int64_t>(gyroscope_sample.sensor_timestamp_ns));
+      comparison.double_tilt_error.Add(
+          GetTiltAngleBetween(double_rotation, truth));
+      comparison.float_tilt_error.Add(
+          GetTiltAngleBetween(float_rotation, truth));
+      comparison.bias_state_tilt_error.Add(GetTiltAngleBetween(
+          bias_state_fusion.GetLatestRotationState().sensor_from_start_rotation,
+          truth));
+    }
+  }
+  comparison.double_jacobian_error =
+      double_fusion.GetMaxMeasurementJacobianError();
+  comparison.float_jacobian_error =
+      float_fusion.GetMaxMeasurementJacobianError();
+  return comparison;
+}
+
+void PrintStatistics(const char* name, const AngleStatistics& statistics) {
+  std::printf("  %-34s %12.3f %12.3f\n", name,
+              statistics.GetRms() * kRadiansToMicroradians,
+              statistics.GetMax() * kRadiansToMicroradians);
+}
+
+// Prints @p comparison and returns false if a measurement Jacobian error is
+// above the tolerance of the cross-check.
+bool PrintComparison(const std::string& name, const Comparison& comparison,
+                     bool has_ground_truth, bool check_jacobian) {
+  std::printf("%s\n  %-34s %12s %12s\n", name.c_str(), "angle (urad)", "rms",
+              "max");
+  PrintStatistics("float vs double, current", comparison.current_difference);
+  PrintStatistics("float vs double, predicted",
+                  comparison.predicted_difference);
+  if (has_ground_truth) {
+    PrintStatistics("double tilt error", comparison.double_tilt_error);
+    PrintStatistics("float tilt error", comparison.float_tilt_error);
+    PrintStatistics("bias state tilt error", comparison.bias_state_tilt_error);
+  }
+  if (!check_jacobian) {
+    return true;
+  }
+  std::printf("  %-34s %12.3g %12.3g\n", "max Jacobian error (double/float)",
+              comparison.double_jacobian_error,
+              comparison.float_jacobian_error);
+  const double tolerance = SensorFusionEkf::kMeasurementJacobianCheckTolerance;
+  return comparison.double_jacobian_error <= tolerance &&
+         comparison.float_jacobian_error <= tolerance;
+}
+
+// Returns the value of a "--name=value" argument, or nullptr.
+const char* GetFlagValue(const char* arg, const char* name) {
+  const size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) == 0 && arg[length] == '=') {
+    return arg + length + 1;
+  }
+  return nullptr;
+}
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: holokit_fusion_precision [<trace>] "
+               "[--duration-s=<s>] [--check-jacobian]\n");
+}
+
+}  // namespace
+
+}  // namespace cardboard::benchmarks
+
+int main(int argc, char** argv) {
+  using cardboard::SensorTrace;
+  using cardboard::benchmarks::Compare;
+  using cardboard::benchmarks::GetFlagValue;
+  using cardboard::benchmarks::kStartTimestampNs;
+  using cardboard::benchmarks::PrintComparison;
+  using cardboard::benchmarks::PrintUsage;
+  using cardboard::benchmarks::SyntheticMotion;
+  std::string trace_path;
+  double duration_s = 600;
+  bool check_jacobian = false;
+  for (int i = 1; i < argc; ++i) {
+    if (const char* value = GetFlagValue(argv[i], "--duration-s")) {
+      duration_s = std::atof(value);
+    } else if (std::strcmp(argv[i], "--check-jacobian") == 0) {
+      check_jacobian = true;
+    } else if (argv[i][0] != '-' && trace_path.empty()) {
+      trace_path = argv[i];
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  if (!trace_path.empty()) {
+    const std::unique_ptr<SensorTrace> trace =
+        SensorTrace::LoadFromFile(trace_path);
+    if (!trace) {
+      return 1;
+    }
+    return PrintComparison(trace_path,
+                           Compare(*trace, nullptr, check_jacobian),
+                           /*has_ground_truth=*/false, check_jacobian)
+               ? 0
+               : 1;
+  }
+
+  if (duration_s <= 0) {
+    PrintUsage();
+    return 1;
+  }
+  const int64_t duration_ns = static_cast<int64_t>(duration_s * 1e9);
+  const struct {
+    const char* name;
+    SyntheticMotion::Profile profile;
+  } kProfiles[] = {
+      {"synthetic looking around", SyntheticMotion::Profile::kLookingAround},
+      {"synthetic still", SyntheticMotion::Profile::kStill},
+  };
+  bool success = true;
+  for (const auto& profile : kProfiles) {
+    SyntheticMotion motion(profile.profile);
+    const std::unique_ptr<SensorTrace> trace =
+        motion.MakeTrace(kStartTimestampNs, duration_ns);
+    if (!PrintComparison(profile.name,
+                         Compare(*trace, &motion, check_jacobian),
+                         /*has_ground_truth=*/true, check_jacobian)) {
+      success = false;
+    }
+  }
+  return success ? 0 : 1;
+}
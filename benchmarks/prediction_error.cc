@@ -0,0 +1,294 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Compares the rotation prediction models of the sensor fusion.
+//
+// The IMU samples are fed to a SensorFusionEkf in timestamp order. After every
+// gyroscope sample, the rotation is predicted a few horizons ahead with each
+// RotationPredictionModel. The error of a prediction is the angle between the
+// predicted rotation increment, from the current estimate to the prediction,
+// and the reference increment over the same horizon. On synthetic motion the
+// reference is the ground truth. On a recorded trace it is the estimate the
+// filter reaches at the predicted timestamp, which is what would have been
+// displayed with a perfect predictor. Comparing increments keeps the drift of
+// the heading, which the accelerometer cannot observe, out of the error.
+//
+// Usage:
+//   holokit_prediction_error [<trace>] [--duration-s=<s>]
+//
+// Without a trace, synthetic traces of --duration-s seconds (default 120) are
+// generated for every motion profile.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sensors/sensor_fusion_ekf.h"
+#include "sensors/sensor_trace.h"
+#include "synthetic_motion.h"
+#include "util/rotation.h"
+#include "util/vectorutils.h"
+
+namespace cardboard::benchmarks {
+
+namespace {
+
+constexpr int64_t kStartTimestampNs = 1000000000;
+// Time left to the filter to align with gravity before predictions are
+// scored.
+constexpr int64_t kWarmupNs = 2000000000;
+constexpr double kRadiansToMilliradians = 1e3;
+
+constexpr std::array<int64_t, 3> kHorizonsNs = {20000000, 35000000, 50000000};
+
+constexpr struct {
+  const char* name;
+  RotationPredictionModel model;
+} kModels[] = {
+    {"constant velocity", RotationPredictionModel::kConstantVelocity},
+    {"constant acceleration", RotationPredictionModel::kConstantAcceleration},
+};
+constexpr int kModelCount = sizeof(kModels) / sizeof(kModels[0]);
+
+// Maximum and root mean square of a series of angles.
+class AngleStatistics {
+ public:
+  void Add(double angle) {
+    max_ = std::max(max_, angle);
+    sum_of_squares_ += angle * angle;
+    ++count_;
+  }
+
+  double GetMax() const { return max_; }
+  double GetRms() const {
+    return count_ == 0 ? 0 : std::sqrt(sum_of_squares_ / count_);
+  }
+
+ private:
+  double max_ = 0;
+  double sum_of_squares_ = 0;
+  int64_t count_ = 0;
+};
+
+// Prediction errors, indexed by model and horizon.
+typedef std::array<std::array<AngleStatistics, kHorizonsNs.size()>,
+                   kModelCount>
+    Errors;
+
+// Filter estimate and predictions after one gyroscope sample.
+struct Estimate {
+  int64_t system_timestamp;
+  int64_t sensor_timestamp;
+  Rotation rotation;
+  std::array<std::array<Rotation, kHorizonsNs.size()>, kModelCount> predicted;
+};
+
+// Returns the angle of the rotation between @p a and @p b in radians.
+double GetAngleBetween(const Rotation& a, const Rotation& b) {
+  const Vector4 q = (-a * b).GetQuaternion();
+  return 2 * std::atan2(Length(Vector3(q[0], q[1], q[2])), std::abs(q[3]));
+}
+
+// Returns the filter estimate at @p system_timestamp, interpolated between the
+// estimates that surround it. Returns false if it is after the last estimate.
+bool GetEstimateAt(const std::vector<Estimate>& estimates,
+                   int64_t system_timestamp, Rotation* rotation) {
+  const auto next = std::lower_bound(
+      estimates.begin(), estimates.end(), system_timestamp,
+      [](const Estimate& estimate, int64_t timestamp) {
+        return estimate.system_timestamp < timestamp;
+      });
+  if (next == estimates.end()) {
+    return false;
+  }
+  if (next == estimates.begin() ||
+      next->system_timestamp == system_timestamp) {
+    *rotation = next->rotation;
+    return true;
+  }
+  const auto previous = next - 1;
+  const double t =
+      static_cast<double>(system_timestamp - previous->system_timestamp) /
+      static_cast<double>(next->system_timestamp - previous->system_timestamp);
+  *rotation = Rotation::Slerp(previous->rotation, next->rotation, t);
+  return true;
+}
+
+// Replays @p trace and scores the predictions. @p motion, if not null,
+// provides the ground truth of a synthetic trace.
+Errors Compare(const SensorTrace& trace, const SyntheticMotion* motion) {
+  SensorFusionEkf sensor_fusion;
+  std::vector<Estimate> estimates;
+
+  const std::vector<AccelerometerData>& accelerometer_samples =
+      trace.GetAccelerometerSamples();
+  const std::vector<GyroscopeData>& gyroscope_samples =
+      trace.GetGyroscopeSamples();
+  estimates.reserve(gyroscope_samples.size());
+  size_t next_accelerometer = 0;
+  for (const GyroscopeData& gyroscope_sample : gyroscope_samples) {
+    while (next_accelerometer < accelerometer_samples.size() &&
+           accelerometer_samples[next_accelerometer].sensor_timestamp_ns <=
+               gyroscope_sample.sensor_timestamp_ns) {
+      sensor_fusion.ProcessAccelerometerSample(
+          accelerometer_samples[next_accelerometer]);
+      ++next_accelerometer;
+    }
+    sensor_fusion.ProcessGyroscopeSample(gyroscope_sample);
+
+    Estimate estimate;
+    estimate.system_timestamp =
+        static_cast<int64_t>(gyroscope_sample.system_timestamp);
+    estimate.sensor_timestamp =
+        static_cast<int64_t>(gyroscope_sample.sensor_timestamp_ns);
+    estimate.rotation =
+        sensor_fusion.GetLatestRotationState().sensor_from_start_rotation;
+    for (int model = 0; model < kModelCount; ++model) {
+      sensor_fusion.SetRotationPredictionModel(kModels[model].model);
+      for (size_t horizon = 0; horizon < kHorizonsNs.size(); ++horizon) {
+        estimate.predicted[model][horizon] = sensor_fusion.PredictRotation(
+            estimate.system_timestamp + kHorizonsNs[horizon]);
+      }
+    }
+    estimates.push_back(estimate);
+  }
+
+  Errors errors;
+  if (estimates.empty()) {
+    return errors;
+  }
+  const int64_t first_scored_timestamp =
+      estimates.front().system_timestamp + kWarmupNs;
+  for (const Estimate& estimate : estimates) {
+    if (estimate.system_timestamp < first_scored_timestamp) {
+      continue;
+    }
+    for (size_t horizon = 0; horizon < kHorizonsNs.size(); ++horizon) {
+      Rotation reference_increment;
+      if (motion != nullptr) {
+        reference_increment =
+            motion->GetSensorFromStartRotation(estimate.sensor_timestamp +
+                                               kHorizonsNs[horizon]) *
+            -motion->GetSensorFromStartRotation(estimate.sensor_timestamp);
+      } else {
+        Rotation reference;
+        if (!GetEstimateAt(estimates,
+                           estimate.system_timestamp + kHorizonsNs[horizon],
+                           &reference)) {
+          continue;
+        }
+        reference_increment = reference * -estimate.rotation;
+      }
+      for (int model = 0; model < kModelCount; ++model) {
+        const Rotation predicted_increment =
+            estimate.predicted[model][horizon] * -estimate.rotation;
+        errors[model][horizon].Add(
+            GetAngleBetween(predicted_increment, reference_increment));
+      }
+    }
+  }
+  return errors;
+}
+
+void PrintErrors(const std::string& name, const Errors& errors) {
+  std::printf("%s\n  %-34s %8s %12s %12s\n", name.c_str(), "error (mrad)",
+              "horizon", "rms", "max");
+  for (int model = 0; model < kModelCount; ++model) {
+    for (size_t horizon = 0; horizon < kHorizonsNs.size(); ++horizon) {
+      const AngleStatistics& statistics = errors[model][horizon];
+      std::printf("  %-34s %5d ms %12.3f %12.3f\n", kModels[model].name,
+                  static_cast<int>(kHorizonsNs[horizon] / 1000000),
+                  statistics.GetRms() * kRadiansToMilliradians,
+                  statistics.GetMax() * kRadiansToMilliradians);
+    }
+  }
+}
+
+// Returns the value of a "--name=value" argument, or nullptr.
+const char* GetFlagValue(const char* arg, const char* name) {
+  const size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) == 0 && arg[length] == '=') {
+    return arg + length + 1;
+  }
+  return nullptr;
+}
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: holokit_prediction_error [<trace>] "
+               "[--duration-s=<s>]\n");
+}
+
+}  // namespace
+
+}  // namespace cardboard::benchmarks
+
+int main(int argc, char** argv) {
+  using cardboard::SensorTrace;
+  using cardboard::benchmarks::Compare;
+  using cardboard::benchmarks::GetFlagValue;
+  using cardboard::benchmarks::kStartTimestampNs;
+  using cardboard::benchmarks::PrintErrors;
+  using cardboard::benchmarks::PrintUsage;
+  using cardboard::benchmarks::SyntheticMotion;
+  std::string trace_path;
+  double duration_s = 120;
+  for (int i = 1; i < argc; ++i) {
+    if (const char* value = GetFlagValue(argv[i], "--duration-s")) {
+      duration_s = std::atof(value);
+    } else if (argv[i][0] != '-' && trace_path.empty()) {
+      trace_path = argv[i];
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  if (!trace_path.empty()) {
+    const std::unique_ptr<SensorTrace> trace =
+        SensorTrace::LoadFromFile(trace_path);
+    if (!trace) {
+      return 1;
+    }
+    PrintErrors(trace_path, Compare(*trace, nullptr));
+    return 0;
+  }
+
+  if (duration_s <= 0) {
+    PrintUsage();
+    return 1;
+  }
+  const int64_t duration_ns = static_cast<int64_t>(duration_s * 1e9);
+  const struct {
+    const char* name;
+    SyntheticMotion::Profile profile;
+  } kProfiles[] = {
+      {"synthetic looking around", SyntheticMotion::Profile::kLookingAround},
+      {"synthetic head turns", SyntheticMotion::Profile::kHeadTurns},
+      {"synthetic still", SyntheticMotion::Profile::kStill},
+  };
+  for (const auto& profile : kProfiles) {
+    SyntheticMotion motion(profile.profile);
+    const std::unique_ptr<SensorTrace> trace =
+        motion.MakeTrace(kStartTimestampNs, duration_ns);
+    PrintErrors(profile.name, Compare(*trace, &motion));
+  }
+  return 0;
+}
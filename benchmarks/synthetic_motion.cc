@@ -0,0 +1,142 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "synthetic_motion.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/vectorutils.h"
+
+namespace cardboard::benchmarks {
+
+namespace {
+
+constexpr double kGravity = 9.81;
+constexpr double kTwoPi = 2.0 * M_PI;
+// Step used to differentiate the orientation into an angular velocity.
+constexpr int64_t kDifferentiationStepNs = 1000000;
+// Head turns of the kHeadTurns profile.
+constexpr double kHeadTurnAngle = 0.8;
+constexpr double kHeadTurnDuration_s = 0.4;
+constexpr double kHeadTurnPeriod_s = 1.5;
+
+double ToSeconds(int64_t timestamp_ns) {
+  return static_cast<double>(timestamp_ns) * 1e-9;
+}
+
+// Minimum jerk interpolation from 0 to 1 over @p u in [0, 1].
+double MinimumJerk(double u) {
+  u = std::min(std::max(u, 0.0), 1.0);
+  return u * u * u * (10.0 - 15.0 * u + 6.0 * u * u);
+}
+
+}  // namespace
+
+SyntheticMotion::SyntheticMotion(Profile profile, uint32_t seed)
+    : profile_(profile),
+      amplitude_(profile == Profile::kStill ? 0.002 : 1.0),
+      gyroscope_bias_(0.004, -0.003, 0.002),
+      random_engine_(seed),
+      accelerometer_noise_(0.0, profile == Profile::kStill ? 0.01 : 0.05),
+      gyroscope_noise_(0.0, 0.002) {}
+
+Rotation SyntheticMotion::GetSensorFromStartRotation(
+    int64_t timestamp_ns) const {
+  const double t = ToSeconds(timestamp_ns);
+  if (profile_ == Profile::kHeadTurns) {
+    // Turns alternate between yaw 0 and kHeadTurnAngle.
+    const double cycle = std::floor(t / kHeadTurnPeriod_s);
+    const double progress =
+        MinimumJerk((t - cycle * kHeadTurnPeriod_s) / kHeadTurnDuration_s);
+    const bool is_turning_back = std::fmod(cycle, 2.0) != 0.0;
+    const double yaw =
+        kHeadTurnAngle * (is_turning_back ? 1.0 - progress : progress);
+    const double pitch = 0.05 * std::sin(kTwoPi * 0.5 * t);
+    return -Rotation::FromYawPitchRoll(yaw, pitch, 0.0);
+  }
+  const double yaw = amplitude_ * (0.6 * std::sin(kTwoPi * 0.3 * t) +
+                                   0.2 * std::sin(kTwoPi * 1.1 * t));
+  const double pitch = amplitude_ * 0.25 * std::sin(kTwoPi * 0.5 * t + 1.0);
+  const double roll = amplitude_ * 0.1 * std::sin(kTwoPi * 0.7 * t + 2.0);
+  return -Rotation::FromYawPitchRoll(yaw, pitch, roll);
+}
+
+Vector3 SyntheticMotion::GetPosition(int64_t timestamp_ns) const {
+  const double t = ToSeconds(timestamp_ns);
+  return amplitude_ * Vector3(0.10 * std::sin(kTwoPi * 0.2 * t),
+                              0.03 * std::sin(kTwoPi * 0.4 * t + 0.5),
+                              0.08 * std::sin(kTwoPi * 0.25 * t + 1.5));
+}
+
+AccelerometerData SyntheticMotion::GetAccelerometerSample(
+    int64_t timestamp_ns) {
+  const Vector3 gravity = GetSensorFromStartRotation(timestamp_ns) *
+                          Vector3(0.0, 0.0, kGravity);
+  const Vector3 noise(accelerometer_noise_(random_engine_),
+                      accelerometer_noise_(random_engine_),
+                      accelerometer_noise_(random_engine_));
+  const uint64_t timestamp = static_cast<uint64_t>(timestamp_ns);
+  return {timestamp, timestamp, gravity + noise};
+}
+
+GyroscopeData SyntheticMotion::GetGyroscopeSample(int64_t timestamp_ns) {
+  // The EKF integrates sensor_from_start(t + dt) =
+  // Exp(-w dt) * sensor_from_start(t).
+  const Rotation step =
+      GetSensorFromStartRotation(timestamp_ns + kDifferentiationStepNs) *
+      -GetSensorFromStartRotation(timestamp_ns);
+  const Vector3 velocity = step.Log() / -ToSeconds(kDifferentiationStepNs);
+  const Vector3 noise(gyroscope_noise_(random_engine_),
+                      gyroscope_noise_(random_engine_),
+                      gyroscope_noise_(random_engine_));
+  const uint64_t timestamp = static_cast<uint64_t>(timestamp_ns);
+  return {timestamp, timestamp, velocity + gyroscope_bias_ + noise};
+}
+
+SixDoFData SyntheticMotion::GetSixDoFSample(int64_t timestamp_ns) {
+  const Vector3 position = GetPosition(timestamp_ns);
+  const Vector4 orientation =
+      (-GetSensorFromStartRotation(timestamp_ns)).GetQuaternion();
+  SixDoFData sample;
+  sample.system_timestamp = static_cast<uint64_t>(timestamp_ns);
+  sample.sensor_timestamp_ns = sample.system_timestamp;
+  for (int i = 0; i < 3; ++i) {
+    sample.position[i] = static_cast<float>(position[i]);
+  }
+  for (int i = 0; i < 4; ++i) {
+    sample.orientation[i] = static_cast<float>(orientation[i]);
+  }
+  return sample;
+}
+
+std::unique_ptr<SensorTrace> SyntheticMotion::MakeTrace(int64_t start_ns,
+                                                        int64_t duration_ns) {
+  std::unique_ptr<SensorTrace> trace(new SensorTrace());
+  for (int64_t t = start_ns; t < start_ns + duration_ns; t += kImuPeriodNs) {
+    trace->AddAccelerometerSample(GetAccelerometerSample(t));
+    // Offset the gyroscope slightly like on device, where both sensors are not
+    // sampled at the same instant.
+    trace->AddGyroscopeSample(GetGyroscopeSample(t + 500000));
+  }
+  for (int64_t t = start_ns; t < start_ns + duration_ns;
+       t += kSixDoFPeriodNs) {
+    trace->AddSixDoFSample(GetSixDoFSample(t));
+  }
+  trace->Sort();
+  return trace;
+}
+
+}  // namespace cardboard::benchmarks
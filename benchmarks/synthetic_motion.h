@@ -0,0 +1,88 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef HOLOKIT_BENCHMARKS_SYNTHETIC_MOTION_H_
+#define HOLOKIT_BENCHMARKS_SYNTHETIC_MOTION_H_
+
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "sensors/accelerometer_data.h"
+#include "sensors/gyroscope_data.h"
+#include "sensors/sensor_trace.h"
+#include "sensors/sixdof_data.h"
+#include "util/rotation.h"
+#include "util/vector.h"
+
+namespace cardboard::benchmarks {
+
+// Deterministic head motion used to feed the benchmarks.
+//
+// The head orientation is a sum of low frequency yaw, pitch and roll
+// oscillations, which is roughly what a user looking around produces, or a
+// series of quick head turns. IMU
+// samples are derived from it with a constant gyroscope bias and white
+// noise, using a fixed seed so that every run sees the same samples.
+class SyntheticMotion {
+ public:
+  enum class Profile {
+    // Looking around: up to ~2 rad/s of yaw velocity.
+    kLookingAround,
+    // Holding the head still with a small tremor. Exercises the static paths
+    // of the gyroscope bias estimator.
+    kStill,
+    // Quick yaw turns of 0.8 rad with a minimum jerk profile, peaking at
+    // 3.75 rad/s, each followed by a pause. Exercises the start and end of
+    // head turns, where the angular velocity changes the most.
+    kHeadTurns,
+  };
+
+  explicit SyntheticMotion(Profile profile, uint32_t seed = 1);
+
+  // Start to sensor rotation at @p timestamp_ns, following the
+  // SensorFusionEkf convention.
+  Rotation GetSensorFromStartRotation(int64_t timestamp_ns) const;
+
+  // Head position in meters at @p timestamp_ns.
+  Vector3 GetPosition(int64_t timestamp_ns) const;
+
+  // @{ Noisy sensor samples at @p timestamp_ns.
+  AccelerometerData GetAccelerometerSample(int64_t timestamp_ns);
+  GyroscopeData GetGyroscopeSample(int64_t timestamp_ns);
+  SixDoFData GetSixDoFSample(int64_t timestamp_ns);
+  // @}
+
+  // Builds a trace of @p duration_ns starting at @p start_ns with IMU samples
+  // at 100 Hz and 6DoF samples at 60 Hz.
+  std::unique_ptr<SensorTrace> MakeTrace(int64_t start_ns,
+                                         int64_t duration_ns);
+
+  // IMU and 6DoF sample periods of the generated traces.
+  static constexpr int64_t kImuPeriodNs = 10000000;
+  static constexpr int64_t kSixDoFPeriodNs = 16666667;
+
+ private:
+  const Profile profile_;
+  const double amplitude_;
+  const Vector3 gyroscope_bias_;
+  std::mt19937 random_engine_;
+  std::normal_distribution<double> accelerometer_noise_;
+  std::normal_distribution<double> gyroscope_noise_;
+};
+
+}  // namespace cardboard::benchmarks
+
+#endif  // HOLOKIT_BENCHMARKS_SYNTHETIC_MOTION_H_
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2026 Holo Interactive Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Replays a recorded sensor trace through HeadTracker on a workstation and
+// prints the predicted pose of every rendered frame as CSV:
+//
+//   timestamp_ns,px,py,pz,qx,qy,qz,qw
+//
+// Usage:
+//   holokit_trace_replay <trace> [--rate=<r>] [--frame-rate=<hz>]
+//                        [--prediction-ms=<ms>]
+//
+// --rate=1 (default) replays in real time, --rate=0 as fast as possible.
+// When the trace has 6DoF poses, the statistics of the replays that applied
+// their orientations are printed to stderr at the end.
+#include <array>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "head_tracker.h"
+#include "sensors/linux/trace_player.h"
+#include "sensors/sensor_event_producer.h"
+#include "sensors/sensor_trace.h"
+#include "sensors/sixdof_data.h"
+
+namespace {
+
+constexpr int64_t kNanosInSeconds = 1000000000;
+constexpr int64_t kNanosInMilliseconds = 1000000;
+
+// Returns the value of a "--name=value" argument, or nullptr.
+const char* GetFlagValue(const char* arg, const char* name) {
+  const size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) == 0 && arg[length] == '=') {
+    return arg + length + 1;
+  }
+  return nullptr;
+}
+
+void PrintUsage() {
+  std::fprintf(stderr,
+               "Usage: holokit_trace_replay <trace> [--rate=<r>] "
+               "[--frame-rate=<hz>] [--prediction-ms=<ms>]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    PrintUsage();
+    return 1;
+  }
+
+  const std::string trace_path = argv[1];
+  double playback_rate = 1.0;
+  double frame_rate_hz = 60.0;
+  double prediction_ms = 50.0;
+  for (int i = 2; i < argc; ++i) {
+    if (const char* value = GetFlagValue(argv[i], "--rate")) {
+      playback_rate = std::atof(value);
+    } else if (const char* value = GetFlagValue(argv[i], "--frame-rate")) {
+      frame_rate_hz = std::atof(value);
+    } else if (const char* value = GetFlagValue(argv[i], "--prediction-ms")) {
+      prediction_ms = std::atof(value);
+    } else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if (frame_rate_hz <= 0) {
+    PrintUsage();
+    return 1;
+  }
+
+  std::shared_ptr<const cardboard::SensorTrace> trace =
+      cardboard::SensorTrace::LoadFromFile(trace_path);
+  if (!trace) {
+    return 1;
+  }
+  if (trace->GetAccelerometerSamples().empty() ||
+      trace->GetGyroscopeSamples().empty()) {
+    std::fprintf(stderr, "Trace %s has no accelerometer or gyroscope data.\n",
+                 trace_path.c_str());
+    return 1;
+  }
+  cardboard::TracePlayer::SetTrace(trace, playback_rate);
+
+  cardboard::HeadTracker head_tracker;
+  head_tracker.Resume();
+
+  cardboard::SensorEventProducer<cardboard::SixDoFData> sixdof_producer;
+  const std::function<void(cardboard::SixDoFData)> on_sixdof_callback =
+      [&head_tracker](cardboard::SixDoFData event) {
+        head_tracker.AddSixDoFData(
+            static_cast<int64_t>(event.sensor_timestamp_ns),
+            event.position.data(), event.orientation.data());
+      };
+  if (!trace->GetSixDoFSamples().empty()) {
+    sixdof_producer.StartSensorPolling(&on_sixdof_callback);
+  }
+  cardboard::TracePlayer::Start();
+
+  const int64_t frame_period_ns =
+      static_cast<int64_t>(kNanosInSeconds / frame_rate_hz);
+  const int64_t prediction_ns =
+      static_cast<int64_t>(prediction_ms * kNanosInMilliseconds);
+  int64_t next_frame_ns = trace->GetStartTimestamp() + frame_period_ns;
+
+  std::printf("timestamp_ns,px,py,pz,qx,qy,qz,qw\n");
+  while (!cardboard::TracePlayer::IsFinished()) {
+    const int64_t now_ns = cardboard::TracePlayer::GetCurrentTimestamp();
+    if (now_ns < next_frame_ns) {
+      if (playback_rate > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+      } else {
+        std::this_thread::yield();
+      }
+      continue;
+    }
+
+    std::array<float, 3> position;
+    std::array<float, 4> orientation;
+    head_tracker.GetPose(next_frame_ns + prediction_ns, kLandscapeLeft,
+                         position, orientation);
+    std::printf("%lld,%f,%f,%f,%f,%f,%f,%f\n",
+                static_cast<long long>(next_frame_ns), position[0],
+                position[1], position[2], orientation[0], orientation[1],
+                orientation[2], orientation[3]);
+    next_frame_ns += frame_period_ns;
+  }
+
+  sixdof_producer.StopSensorPolling();
+  head_tracker.Pause();
+
+  if (!trace->GetSixDoFSamples().empty()) {
+    const cardboard::SensorFusionReplayStatistics statistics =
+        head_tracker.GetSixDoFReplayStatistics();
+    std::fprintf(stderr,
+                 "6DoF orientations: %lld applied, %lld rejected\n"
+                 "replayed samples: %d last, %d max\n"
+                 "replay duration: %.1f us last, %.1f us max\n",
+                 static_cast<long long>(statistics.applied_measurements),
+                 static_cast<long long>(statistics.rejected_measurements),
+                 statistics.last_replayed_samples,
+                 statistics.max_replayed_samples,
+                 statistics.last_replay_duration_ns * 1e-3,
+                 statistics.max_replay_duration_ns * 1e-3);
+  }
+  return 0;
+}